@@ -0,0 +1,238 @@
+/**********************************************************
+   Spectrum Analyzer Screen
+
+   Shows the spectrum of the input (mixer1) on the top half
+   of the screen and the output (mixer4) on the bottom half,
+   from 256 point FFTs, grouped into 24 log spaced bands
+   from 172 Hz to 20 kHz. Each band has a peak hold marker
+   that holds for a second then falls.
+
+   The FFT nodes are only connected while this screen is
+   shown, so they cost nothing the rest of the time. The
+   display is redrawn at a fixed frame rate, and only the
+   part of each bar that changed is drawn.
+
+   version 1.0   Oct 2026
+
+   Audio chain:
+   Mixer1 -> FFT256_1     (while screen shown)
+   Mixer4 -> FFT256_2
+
+ * **************************************************************/
+
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+
+#include "guiItems.h"
+
+
+// analyzer taps, connected by the analyzer screen
+AudioConnection  fftInCord(mixer1, fft256_1);
+AudioConnection  fftOutCord(mixer4, fft256_2);
+
+
+class Analyzer {
+  public:
+    Analyzer();
+    void init();
+    void process(bool);
+    void close();
+    bool isOpen();
+
+  private:
+    static const uint8_t numBands = 24;
+    static const uint8_t numSpectra = 2;
+    static const uint8_t frameMs = 50;          // 20 frames per sec
+    static const uint16_t peakHoldMs = 1000;
+
+    // fft bins at the band edges, log spaced
+    const uint8_t bandEdges[numBands + 1] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+                                             14, 16, 20, 24, 29, 36, 43, 53, 65, 79, 96, 117};
+
+    // display, dB range shown & bar layout
+    const float floordB = -72.0;
+    static const int16_t barX = 4;
+    static const int16_t barWidth = 10;
+    static const int16_t barSpacing = 12;
+    static const int16_t spectrumHeight = 95;
+    const int16_t spectrumY[numSpectra] = {5, 110};
+
+    bool connected;
+    elapsedMillis frameTime;
+
+    int16_t barHeight[numSpectra][numBands];
+    int16_t peakHeight[numSpectra][numBands];
+    uint32_t peakTime[numSpectra][numBands];
+
+    void open();
+    int16_t readBand(AudioAnalyzeFFT256 &fft, uint8_t band);
+    void drawScreen(bool drawAll);
+    void drawBar(uint8_t s, uint8_t band, int16_t height);
+};
+
+
+
+Analyzer :: Analyzer()
+{
+  connected = true;
+}
+
+
+
+// run after audio board is initialized
+void Analyzer :: init()
+{
+  fft256_1.windowFunction(AudioWindowHanning256);
+  fft256_2.windowFunction(AudioWindowHanning256);
+  close();
+  printValue("Analyzer initialized");
+}
+
+
+
+// connect the FFTs
+void Analyzer :: open()
+{
+  if (connected)
+    return;
+
+  memProfileSample();
+  fftInCord.connect();
+  fftOutCord.connect();
+  connected = true;
+  printValue("Analyzer connected");
+}
+
+
+
+// disconnect the FFTs, called when leaving the screen
+void Analyzer :: close()
+{
+  if (!connected)
+    return;
+
+  memProfileSample();
+  fftInCord.disconnect();
+  fftOutCord.disconnect();
+  connected = false;
+  printValue("Analyzer disconnected");
+}
+
+
+
+// the FFTs are connected
+bool Analyzer :: isOpen()
+{
+  return connected;
+}
+
+
+
+// band level as a bar height
+int16_t Analyzer :: readBand(AudioAnalyzeFFT256 &fft, uint8_t band)
+{
+  float level = fft.read(bandEdges[band], bandEdges[band + 1] - 1);
+  if (level <= 0)
+    return 0;
+
+  float dB = 20.0 * log10f(level);
+  dB = constrain(dB, floordB, 0);
+  return (int16_t)((dB - floordB) * spectrumHeight / -floordB);
+}
+
+
+
+void Analyzer :: process(bool initScreen)
+{
+  if (initScreen)
+  {
+    open();
+    drawScreen(true);
+  }
+
+  // throttle the frame rate
+  if (frameTime < frameMs)
+    return;
+  frameTime = 0;
+
+  drawScreen(false);
+}
+
+
+
+void Analyzer :: drawScreen(bool drawAll)
+{
+  AudioAnalyzeFFT256 *ffts[numSpectra] = {&fft256_1, &fft256_2};
+
+  if (drawAll)
+  {
+    eraseScreen();
+    drawTitle("Spectrum");
+
+    tft.setFont(Arial_9);
+    tft.setTextColor(GUI_TEXT_COLOR);
+    tft.setCursor(LCD_WIDTH - 24, spectrumY[0]);
+    tft.print("In");
+    tft.setCursor(LCD_WIDTH - 24, spectrumY[1]);
+    tft.print("Out");
+
+    for (uint8_t s = 0; s < numSpectra; s++)
+    {
+      for (uint8_t b = 0; b < numBands; b++)
+      {
+        barHeight[s][b] = 0;
+        peakHeight[s][b] = 0;
+        peakTime[s][b] = 0;
+      }
+    }
+    return;
+  }
+
+  for (uint8_t s = 0; s < numSpectra; s++)
+  {
+    if (!ffts[s]->available())
+      continue;
+
+    for (uint8_t b = 0; b < numBands; b++)
+      drawBar(s, b, readBand(*ffts[s], b));
+  }
+}
+
+
+
+// only draws the part of the bar that changed, then the peak marker
+void Analyzer :: drawBar(uint8_t s, uint8_t band, int16_t height)
+{
+  int16_t x = barX + band * barSpacing;
+  int16_t base = spectrumY[s] + spectrumHeight;
+  int16_t last = barHeight[s][band];
+
+  if (height > last)
+    tft.fillRect(x, base - height, barWidth, height - last, ILI9341_GREEN);
+  else if (height < last)
+    tft.fillRect(x, base - last, barWidth, last - height, GUI_FILL_COLOR);
+  barHeight[s][band] = height;
+
+  // peak hold, falls 2 pixels a frame after the hold time
+  int16_t peak = peakHeight[s][band];
+  if (height >= peak)
+  {
+    peak = height;
+    peakTime[s][band] = millis();
+  }
+  else if (millis() - peakTime[s][band] > peakHoldMs)
+    peak = max(peak - 2, height);
+
+  if (peak != peakHeight[s][band])
+  {
+    // erase the old marker, unless the bar now covers it
+    if (peakHeight[s][band] > height)
+      tft.drawFastHLine(x, base - peakHeight[s][band], barWidth, GUI_FILL_COLOR);
+    peakHeight[s][band] = peak;
+  }
+  if (peak > height)
+    tft.drawFastHLine(x, base - peak, barWidth, ILI9341_RED);
+}
+
+#endif
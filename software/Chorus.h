@@ -222,7 +222,7 @@ void Chorus :: process(bool initScreen)
     convertToSlider();
 
   // allow some time for user to rotate encoders
-  delay(50);
+  idleDelay(50);
 
   // read encoders and check for changes
   checkEncoders();
@@ -1,23 +1,44 @@
 /**********************************************************
    Compressor Effect Class
 
-   Interface to the audio compressor, built-in to the
-   SGTL-5000 audio IC.
+   Interface to the audio compressor. By default this is the
+   software compressor node (effect_compressor.h) at the
+   start of the audio chain. Comment out USE_SOFTWARE_COMPRESSOR
+   in Teensy_GEP.ino to go back to the compressor built-in to
+   the SGTL-5000 audio IC.
 
-   WARNING: The compressor settings are very finicky and
+   WARNING: The SGTL-5000 compressor settings are very finicky and
    I have been unable to acheive satisfactory results.
-   Future changes expected
 
    Since this is the first screen that combines buttons and
    sliders, (and I waited to do it last), its a bit diferent
    in format. The logic for radio buttons is fun! Experiment
    to see if this is better
 
-   version 1.0  Jan2020
+   version 1.1  Oct 2026
 
    sub-classes effect
 
-   adjustments:
+   software compressor adjustments:
+       gain: makeup gain, 0 = 0dB, 1 = 6dB, 2 = 12dB
+       ratio: 1.0 to 100, gui selects 2, 4, 8 or 20 to 1
+       threshold: 0 to -96 in dBFS
+       attack: time in ms, 0.1 to 50
+       release: time in ms, 10 to 1000
+       knee: soft knee width in dB, 0 = hard (serial only)
+       lookahead: delay audio 1 block (serial only)
+
+   The software compressor also shows a gain reduction meter,
+   0 to 24 dB, drawn down from the top between the buttons and
+   sliders. It's refreshed at a fixed frame rate and only the
+   part of the bar that changed is redrawn. The SGTL-5000 has
+   no register to read back the AVC gain, so there's no meter
+   when using the hardware compressor.
+
+   Audio chain:
+   I2SIn -> Gate1 -> Comp1 -> Mixer1 -> Effects -> I2SOut
+
+   SGTL-5000 adjustments:
        gain: 0 = 0dB, 1 = 6dB, 2 = 12dB
        response (integration time): 0 = 0ms, 1 = 25ms, 2 = 50 ms, 3 = 100 ms (values > 3 permissible)
        hardLimit: 0 = use "soft knee', 1 = hard limit (don't allow values > threshold)
@@ -79,7 +100,27 @@ class Compressor {
     uint8_t numResponseButtons = 4;
     int16_t responseButtonsX = 80;
     int16_t responseButtonsY = 40;
+#ifdef USE_SOFTWARE_COMPRESSOR
+    // the software compressor uses these for ratio instead
+    String responseLabels[4] = {"2:1", "4:1", "8:1", "20:1"};
+    const float ratioSteps[4] = {2.0, 4.0, 8.0, 20.0};
+    uint8_t ratioButton;
+#else
     String responseLabels[4] = {"0ms", "25ms", "50ms", "100ms"};
+#endif
+    uint8_t *responseButton;
+
+#ifdef USE_SOFTWARE_COMPRESSOR
+    // gain reduction meter
+    static const int16_t meterX = 102;
+    static const int16_t meterY = 5;
+    static const int16_t meterWidth = 20;
+    static const int16_t meterHeight = 180;
+    static const uint8_t meterFrameMs = 40;     // 25 frames per sec
+    const float meterRangedB = 24.0;
+    int16_t meterLevel;
+    elapsedMillis meterFrameTime;
+#endif
 
 
     // sliders
@@ -87,7 +128,11 @@ class Compressor {
     int16_t sliderXPos[3] = {145, 205, 265};
     int16_t sliderYPos = 2;
 
+#ifdef USE_SOFTWARE_COMPRESSOR
+    String labels[numItems] = {"Gain", "Ratio", "Thresh", "Attack", "Rel"};
+#else
     String labels[numItems] = {"Gain", "Resp", "Thresh", "Attack", "Decay"};
+#endif
     int16_t labelXPos[numItems] = {5, 63, 128, 193, 254 };
 
 
@@ -95,6 +140,9 @@ class Compressor {
     void convertFromSlider();
     bool checkEncoders();
     void drawScreen(bool drawAll);
+#ifdef USE_SOFTWARE_COMPRESSOR
+    void drawMeter(bool drawAll);
+#endif
 };
 
 
@@ -106,6 +154,13 @@ Compressor :: Compressor()
   selectedItem = 0;
   lastselectedItem = 0;
   selectedItemChanged = false;
+
+#ifdef USE_SOFTWARE_COMPRESSOR
+  responseButton = &ratioButton;
+  meterLevel = 0;
+#else
+  responseButton = &cfg.compResponse;
+#endif
 }
 
 
@@ -122,7 +177,11 @@ void Compressor :: init()
 
 void Compressor :: disable()
 {
+#ifdef USE_SOFTWARE_COMPRESSOR
+  comp1.setBypass(true);
+#else
   audioShield.autoVolumeDisable();
+#endif
   enabled = false;
   printValue("Compressor disabled");
 }
@@ -131,7 +190,11 @@ void Compressor :: disable()
 
 void Compressor :: enable()
 {
+#ifdef USE_SOFTWARE_COMPRESSOR
+  comp1.setBypass(false);
+#else
   audioShield.autoVolumeEnable();
+#endif
   enabled = true;
   printValue("Compressor enabled");
 }
@@ -168,7 +231,17 @@ void Compressor :: setValues(uint8_t g, uint8_t r, float t, float a, float d)
 // this does the actual changes to the audio board
 void Compressor :: update()
 {
+#ifdef USE_SOFTWARE_COMPRESSOR
+  comp1.threshold(cfg.compThreshold);
+  comp1.ratio(cfg.compRatio);
+  comp1.knee(cfg.compKnee);
+  comp1.attack(cfg.compAttackTime);
+  comp1.release(cfg.compReleaseTime);
+  comp1.makeupGain(cfg.compGain * 6.0);
+  comp1.lookahead(cfg.compLookahead);
+#else
   audioShield.autoVolumeControl(cfg.compGain, cfg.compResponse, cfg.compLimit, cfg.compThreshold, cfg.compAttack, cfg.compDecay);
+#endif
   printValue("Compressor Settings Updated");
 }
 
@@ -178,11 +251,20 @@ void Compressor :: printConfig()
 {
   Serial.print(F("Comp Enabled   = "));   Serial.println(enabled);
   Serial.print(F("Comp Gain      = "));   Serial.println(cfg.compGain);
+#ifdef USE_SOFTWARE_COMPRESSOR
+  Serial.print(F("Comp Ratio     = "));   Serial.println(cfg.compRatio);
+  Serial.print(F("Comp Knee      = "));   Serial.println(cfg.compKnee);
+  Serial.print(F("Comp Threshold = "));   Serial.println(cfg.compThreshold);
+  Serial.print(F("Comp Attack ms = "));   Serial.println(cfg.compAttackTime);
+  Serial.print(F("Comp Release ms= "));   Serial.println(cfg.compReleaseTime);
+  Serial.print(F("Comp Lookahead = "));   Serial.println(cfg.compLookahead);
+#else
   Serial.print(F("Comp Response  = "));   Serial.println(cfg.compResponse);
   Serial.print(F("Comp Limit     = "));   Serial.println(cfg.compLimit);
   Serial.print(F("Comp Threshold = "));   Serial.println(cfg.compThreshold);
   Serial.print(F("Comp Attack    = "));   Serial.println(cfg.compAttack);
   Serial.print(F("Comp Decay     = "));   Serial.println(cfg.compDecay);
+#endif
 }
 
 
@@ -192,8 +274,21 @@ void Compressor :: convertToSlider()
 {
   // convert Compressor values 0.0 to 1.0 to slider value 0 to 100.0
   sliderVal[0] = cfg.compThreshold * (100.0 / -96.0);     // range is 0 to -96
+#ifdef USE_SOFTWARE_COMPRESSOR
+  sliderVal[1] = (cfg.compAttackTime - 0.1) * (100.0 / 49.9);     // 0.1 to 50 ms
+  sliderVal[2] = (cfg.compReleaseTime - 10.0) * (100.0 / 990.0);  // 10 to 1000 ms
+
+  // nearest ratio button
+  ratioButton = 0;
+  for (uint8_t i = 1; i < numResponseButtons; i++)
+  {
+    if (cfg.compRatio >= ratioSteps[i])
+      ratioButton = i;
+  }
+#else
   sliderVal[1] = cfg.compAttack  * (100.0 / 100.0);       // range is 0 to 100 ?
   sliderVal[2] = cfg.compDecay  * (100.0 / 100.0);        // range is 0 to 100 ?
+#endif
 }
 
 
@@ -205,8 +300,17 @@ void Compressor :: convertFromSlider()
 {
   // convert slider 0 to 100.0 to Compressor values 0.0 to 1.0
   cfg.compThreshold = sliderVal[0] * (-96.0 / 100.0);
+#ifdef USE_SOFTWARE_COMPRESSOR
+  cfg.compAttackTime  = sliderVal[1] * (49.9 / 100.0) + 0.1;
+  cfg.compReleaseTime = sliderVal[2] * (990.0 / 100.0) + 10.0;
+
+  // only snap the ratio to a button when the buttons were changed
+  if (selectedItem == 1)
+    cfg.compRatio = ratioSteps[ratioButton];
+#else
   cfg.compAttack    = sliderVal[1] * 1.0;
   cfg.compDecay     = sliderVal[2] * 1.0;
+#endif
 }
 
 
@@ -232,12 +336,15 @@ void Compressor :: drawScreen(bool drawAll)
     drawRadioButtons(gainButtonsX, gainButtonsY, numGainButtons, gainLabels, cfg.compGain);
 
     // draw response buttons
-    drawRadioButtons(responseButtonsX, responseButtonsY, numResponseButtons, responseLabels, cfg.compResponse);
+    drawRadioButtons(responseButtonsX, responseButtonsY, numResponseButtons, responseLabels, *responseButton);
 
     // draw sliders
     for (uint8_t i = 0; i < numSliders; i++)
       drawSlider(sliderXPos[i], sliderYPos, sliderVal[i], false);
 
+#ifdef USE_SOFTWARE_COMPRESSOR
+    drawMeter(true);
+#endif
   }
   else
   {
@@ -247,7 +354,7 @@ void Compressor :: drawScreen(bool drawAll)
       drawRadioButtons(gainButtonsX, gainButtonsY, numGainButtons, gainLabels, cfg.compGain);
 
     else if (selectedItem == 1)
-      drawRadioButtons(responseButtonsX, responseButtonsY, numResponseButtons, responseLabels, cfg.compResponse);
+      drawRadioButtons(responseButtonsX, responseButtonsY, numResponseButtons, responseLabels, *responseButton);
 
     else if (selectedItem >= 2)
     {
@@ -269,8 +376,26 @@ void Compressor :: process(bool initScreen)
     convertToSlider();
 
 
+#ifdef USE_SOFTWARE_COMPRESSOR
+  // allow some time for user to rotate encoders, keep the
+  // meter moving & idle() running meanwhile. Like idleDelay()
+  // the wait isn't screen activity, only the meter's drawing
+  bool drawing = dropout1.activities() & ACT_SCREEN;
+  dropout1.activityEnd(ACT_SCREEN);
+
+  elapsedMillis waitTime;
+  while (waitTime < 50)
+  {
+    drawMeter(false);
+    idle();
+  }
+
+  if (drawing)
+    dropout1.activityStart(ACT_SCREEN);
+#else
   // allow some time for user to rotate encoders
-  delay(50);
+  idleDelay(50);
+#endif
 
   // read encoders and check for changes
   checkEncoders();
@@ -295,6 +420,47 @@ void Compressor :: process(bool initScreen)
 
 
 
+#ifdef USE_SOFTWARE_COMPRESSOR
+// gain reduction bar, drawn from the top down. Only draws
+// once per frame, and then only the rows that changed.
+// Tagged as screen activity, if it isn't already
+void Compressor :: drawMeter(bool drawAll)
+{
+  if (!drawAll && meterFrameTime < meterFrameMs)
+    return;
+  meterFrameTime = 0;
+
+  bool drawing = dropout1.activities() & ACT_SCREEN;
+  dropout1.activityStart(ACT_SCREEN);
+
+  float gr = enabled ? comp1.readGainReduction() : 0;
+  int16_t level = (int16_t)(constrain(gr, 0, meterRangedB) * (meterHeight - 2) / meterRangedB);
+
+  int16_t x = meterX + 1;
+  int16_t y = meterY + 1;
+  int16_t w = meterWidth - 2;
+
+  if (drawAll)
+  {
+    tft.drawRect(meterX, meterY, meterWidth, meterHeight, ILI9341_YELLOW);
+    tft.fillRect(x, y, w, meterHeight - 2, GUI_FILL_COLOR);
+    meterLevel = 0;
+  }
+
+  if (level > meterLevel)
+    tft.fillRect(x, y + meterLevel, w, level - meterLevel, ILI9341_RED);
+  else if (level < meterLevel)
+    tft.fillRect(x, y + level, w, meterLevel - level, GUI_FILL_COLOR);
+
+  meterLevel = level;
+
+  if (!drawing)
+    dropout1.activityEnd(ACT_SCREEN);
+}
+#endif
+
+
+
 bool Compressor :: checkEncoders()
 {
   // checks both param & value encoders for changes.
@@ -344,8 +510,8 @@ bool Compressor :: checkEncoders()
 
           // response buttons
           case 1:
-            if (cfg.compResponse < 3)
-              cfg.compResponse += 1;
+            if (*responseButton < 3)
+              *responseButton += 1;
             break;
 
           // threshold
@@ -381,8 +547,8 @@ bool Compressor :: checkEncoders()
 
           // response buttons
           case 1:
-            if (cfg.compResponse > 0)
-              cfg.compResponse -= 1;
+            if (*responseButton > 0)
+              *responseButton -= 1;
             break;
 
           // threshold
@@ -5,7 +5,9 @@
 
    Adds 2 delays each with its own volume and delay time
    Max delay is about 800ms with internal memory on a Teensy
-   3.6, or up to 1.5 seconds with optional external SRAM
+   3.6, or up to 1.5 seconds with optional external SRAM.
+   The sliders go to DELAY_MAX_MS, less with the looper
+   sharing the SRAM (sram.h)
 
 ***************************************************/
 
@@ -173,11 +175,11 @@ void Delayer :: update()
 // convert delay values to slider positions
 void Delayer :: convertToSlider()
 {
-  // convert Delay settings, delay 100% = 1000ms, volume 1.0 = 100%
+  // convert Delay settings, delay 100% = DELAY_MAX_MS (sram.h), volume 1.0 = 100%
   for (uint8_t i = 0; i < numDelays; i++)
   {
     // delay
-    sliderVal[i] = cfg.delayTimes[i] / 10.0;   // 1000ms = 100%
+    sliderVal[i] = cfg.delayTimes[i] * 100.0 / DELAY_MAX_MS;
     sliderVal[i] = constrain(sliderVal[i], 0, 100);
 
     // volume
@@ -196,8 +198,8 @@ void Delayer :: convertFromSlider()
 {
   for (uint8_t i = 0; i < numDelays ; i++)
   {
-    cfg.delayTimes[i] = sliderVal[i] * 10.0;  // 100% = 1000ms
-    cfg.delayTimes[i] = constrain(cfg.delayTimes[i], 0, 1000);
+    cfg.delayTimes[i] = sliderVal[i] * DELAY_MAX_MS / 100.0;
+    cfg.delayTimes[i] = constrain(cfg.delayTimes[i], 0, DELAY_MAX_MS);
     printValue("delay time", i, cfg.delayTimes[i]);
 
     cfg.delayVols[i] = sliderVal[i + numDelays] / 100.0; // 100% = 1.0
@@ -251,7 +253,7 @@ void Delayer :: process(bool initScreen)
 
 
   // allow some time for user to rotate encoders
-  delay(50);
+  idleDelay(50);
 
   // read encoders and check for changes
   checkEncoders();
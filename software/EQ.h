@@ -4,7 +4,32 @@
     handles the EQ screen drawing and updates
     the EQ settings in the audio chip
 
-    version 2.0.0 Jan2020
+    With USE_SOFTWARE_EQ defined in Teensy_GEP.ino, the
+    SGTL-5000 graphic EQ is left flat and the 8 band
+    parametric EQ node (filter_parametric_eq.h) is used
+    instead. Its screen edits one band at a time: select
+    the band, then adjust its frequency, gain and Q. The
+    lowest band is a low shelf, the highest a high shelf.
+
+    Without it, the SGTL-5000 graphic EQ's 5 band volumes
+    are set from the sliders, +/-1.0 is about +/-12 dB.
+
+    The frequency response of the whole EQ is plotted at 64
+    log spaced points from 20 Hz to 20 kHz, flat while the
+    EQ is off. With the software EQ it's worked out from the
+    biquad coefficients the node is running. The chip's band
+    shapes aren't published, so for the graphic EQ it's an
+    estimate, a peaking filter at each band's centre. It's
+    cached and only recalculated when a band changes or the
+    EQ is turned on or off, then the old curve is erased and
+    the new one drawn over it. With the software EQ it's on
+    the left of the screen, with the graphic EQ it runs
+    across the sliders.
+
+    Audio chain (software EQ):
+    Mixer4 -> Peq1 -> Biquad1 (cab filter) -> I2SOut
+
+    version 2.1.0 Oct 2026
 
  ***************************************************************/
 
@@ -28,7 +53,11 @@ class EQ {
     bool getStatus();
     void printConfig();
     void process(bool);
+#ifdef USE_SOFTWARE_EQ
+    static const uint8_t numEqBands = NUM_PEQ_BANDS;
+#else
     static const uint8_t numEqBands = 5;
+#endif
     void update();
     bool enabled;
 
@@ -39,17 +68,60 @@ class EQ {
     uint8_t selectedItem;
     uint8_t lastselectedItem;
 
+#ifdef USE_SOFTWARE_EQ
+    // band select, then freq, gain & Q sliders for that band
+    static const uint8_t numItems = 4;
+    static const uint8_t numSliders = 3;
+    static const uint8_t firstSlider = 1;
+
+    float sliderVal[numSliders];
+    int16_t sliderXPos[numSliders] = {195, 237, 279};
+    int16_t sliderYPos = 2;
+
+    String labels[numItems] = {"Band", "Freq", "Gain", "Q"};
+    int16_t labelXPos[numItems] = {10, 190, 232, 285};
+
+    uint8_t band;
+
+    uint8_t bandType(uint8_t b);
+    void drawBandInfo();
+#else
+    static const uint8_t numItems = 5;
     static const uint8_t numSliders = 5;
+    static const uint8_t firstSlider = 0;
 
     float sliderVal[numSliders];
     int16_t sliderXPos[numSliders] = {20, 80, 140, 200, 260};
     int16_t sliderYPos = 2;
 
-    String labels[numSliders] = {"100", "250", "600", "1300", "3000"};
+    String labels[numSliders] = {"115", "330", "990", "3000", "9900"};
     int16_t labelXPos[numSliders] = {10, 70, 130, 190, 250};
 
-    const float eqBandFrequencies[numEqBands] = { 100.0, 250.0, 600.0, 1300.0, 3000.0 };
-    int coeffcients[numEqBands];
+    // the graphic EQ's band centres, & the Q the plot uses
+    // for them
+    const float eqBandFrequencies[numEqBands] = { 115.0, 330.0, 990.0, 3000.0, 9900.0 };
+    const float eqPlotQ = 1.0;
+#endif
+
+    // frequency response plot, +/- 12 dB
+    static const uint8_t numPlotPoints = 64;
+    const float plotRangedB = 12.0;
+#ifdef USE_SOFTWARE_EQ
+    int16_t plotX = 5;
+    int16_t plotY = 55;
+    int16_t plotWidth = 175;
+    int16_t plotHeight = 140;
+#else
+    int16_t plotX = 10;
+    int16_t plotY = 5;
+    int16_t plotWidth = 300;
+    int16_t plotHeight = 185;
+#endif
+    int16_t plotYPos[numPlotPoints];
+    bool plotValid;
+
+    void calcResponse();
+    void drawResponse(bool drawAll);
 
     void calcEqCoeffecients();
     void convertToSlider();
@@ -67,6 +139,10 @@ EQ :: EQ()
   selectedItem = 0;
   lastselectedItem = 0;
   selectedItemChanged = false;
+  plotValid = false;
+#ifdef USE_SOFTWARE_EQ
+  band = 0;
+#endif
 }
 
 
@@ -84,8 +160,15 @@ void EQ :: init()
 
 void EQ :: disable()
 {
+#ifdef USE_SOFTWARE_EQ
+  peq1.setBypass(true);
+#else
   audioShield.eqSelect(FLAT_FREQUENCY);   // disable equalizer
+#endif
   enabled = false;
+
+  // plotted flat now
+  plotValid = false;
   printValue("EQ disabled");
 }
 
@@ -93,8 +176,13 @@ void EQ :: disable()
 
 void EQ :: enable()
 {
+#ifdef USE_SOFTWARE_EQ
+  calcEqCoeffecients();
+  peq1.setBypass(false);
+#else
   audioShield.eqSelect(GRAPHIC_EQUALIZER);  // 5-band Graphic Equalizer
   calcEqCoeffecients();
+#endif
   enabled = true;
   printValue("EQ enabled");
 }
@@ -117,14 +205,35 @@ bool EQ :: getStatus()
 
 
 
+#ifdef USE_SOFTWARE_EQ
+// lowest band is a low shelf, highest a high shelf, the rest peaking
+uint8_t EQ :: bandType(uint8_t b)
+{
+  if (b == 0)
+    return PEQ_LOW_SHELF;
+  if (b == numEqBands - 1)
+    return PEQ_HIGH_SHELF;
+  return PEQ_PEAK;
+}
+#endif
+
+
+
 void EQ :: calcEqCoeffecients()
 {
-  // calc and store the EQ parameters for the audio chip
+#ifdef USE_SOFTWARE_EQ
+  // the node calcs the coefficients, flat bands aren't run
   for (uint8_t i = 0; i < numEqBands; i++)
-  {
-    calcBiquad(FILTER_PARAEQ, eqBandFrequencies[i], cfg.eqBandVals[i], 1, 524288, 44100,  coeffcients);
-    audioShield.eqFilter(i, coeffcients);
-  }
+    peq1.setBand(i, bandType(i), cfg.peqFreq[i], cfg.peqGain[i], cfg.peqQ[i]);
+#else
+  // the graphic EQ only uses its band volumes, filters sent
+  // with eqFilter() are for the parametric mode
+  audioShield.eqBands(cfg.eqBandVals[BASS], cfg.eqBandVals[MID_BASS], cfg.eqBandVals[MIDRANGE],
+                      cfg.eqBandVals[MID_TREBLE], cfg.eqBandVals[TREBLE]);
+#endif
+
+  // response plot needs to be recalculated
+  plotValid = false;
 }
 
 
@@ -132,11 +241,22 @@ void EQ :: calcEqCoeffecients()
 void EQ :: printConfig()
 {
   Serial.print(F("EQ Enabled     = "));   Serial.println(enabled);
+#ifdef USE_SOFTWARE_EQ
+  Serial.print(F("EQ Stages used = "));   Serial.println(peq1.stagesInUse());
+  for (uint8_t i = 0; i < numEqBands; i++)
+  {
+    Serial.print(F("EQ Band "));    Serial.print(i + 1);
+    Serial.print(F("      = "));    Serial.print(cfg.peqFreq[i], 0);
+    Serial.print(F(" Hz, "));       Serial.print(cfg.peqGain[i], 1);
+    Serial.print(F(" dB, Q "));     Serial.println(cfg.peqQ[i]);
+  }
+#else
   Serial.print(F("EQ Bass        = "));   Serial.println(cfg.eqBandVals[BASS]);
   Serial.print(F("EQ Mid-Bass    = "));   Serial.println(cfg.eqBandVals[MID_BASS]);
   Serial.print(F("EQ Midrange    = "));   Serial.println(cfg.eqBandVals[MIDRANGE]);
   Serial.print(F("EQ Mid-Treble  = "));   Serial.println(cfg.eqBandVals[MID_TREBLE]);
   Serial.print(F("EQ Treble      = "));   Serial.println(cfg.eqBandVals[TREBLE]);
+#endif
 }
 
 
@@ -153,12 +273,21 @@ void EQ :: update()
 // convert values to slider positions
 void EQ :: convertToSlider()
 {
+#ifdef USE_SOFTWARE_EQ
+  // freq 20 to 20k Hz and Q 0.3 to 10 are log scales
+  sliderVal[0] = log10f(cfg.peqFreq[band] / 20.0) * (100.0 / 3.0);
+  sliderVal[1] = (cfg.peqGain[band] + PEQ_MAX_GAIN) * (100.0 / (2 * PEQ_MAX_GAIN));
+  sliderVal[2] = logf(cfg.peqQ[band] / 0.3) * (100.0 / logf(10.0 / 0.3));
+  for (uint8_t i = 0; i < numSliders; i++)
+    sliderVal[i] = constrain(sliderVal[i], 0, 100);
+#else
   // convert eq settings -1.0 to +1.0 to slider level of 0 to 100%
   for (uint8_t i = 0; i < numSliders; i++)
   {
     sliderVal[i] = (cfg.eqBandVals[i] + 1.0) * 50;
     sliderVal[i] = constrain(sliderVal[i], 0, 100);
   }
+#endif
 }
 
 
@@ -166,12 +295,22 @@ void EQ :: convertToSlider()
 // convert slider positions to values
 void EQ :: convertFromSlider()
 {
+#ifdef USE_SOFTWARE_EQ
+  cfg.peqFreq[band] = 20.0 * powf(10.0, sliderVal[0] * (3.0 / 100.0));
+  cfg.peqGain[band] = sliderVal[1] * ((2 * PEQ_MAX_GAIN) / 100.0) - PEQ_MAX_GAIN;
+  cfg.peqQ[band]    = 0.3 * expf(sliderVal[2] * (logf(10.0 / 0.3) / 100.0));
+
+  // make it easy to get back to flat, so the stage isn't run
+  if (fabsf(cfg.peqGain[band]) < 0.5)
+    cfg.peqGain[band] = 0;
+#else
   // convert slider position to EQ values +/- 1.0
   for (uint8_t i = 0; i < numSliders; i++)
   {
     cfg.eqBandVals[i] = sliderVal[i] / 50.0 - 1.0;
     cfg.eqBandVals[i] = constrain(cfg.eqBandVals[i], -1.0, 1.0);
   }
+#endif
 }
 
 
@@ -187,7 +326,7 @@ void EQ :: process(bool initScreen)
     convertToSlider();
 
   // allow some time for user to rotate encoders
-  delay(50);
+  idleDelay(50);
 
   // read encoders and check for changes
   checkEncoders();
@@ -196,6 +335,14 @@ void EQ :: process(bool initScreen)
   {
     drawScreen(true);
   }
+#ifdef USE_SOFTWARE_EQ
+  else if (itemValueChanged && selectedItem == 0)
+  {
+    // new band selected, load its settings into the sliders
+    convertToSlider();
+    drawScreen(false);
+  }
+#endif
   else if (itemValueChanged)
   {
     convertFromSlider();
@@ -219,24 +366,162 @@ void EQ :: drawScreen(bool drawAll)
     eraseScreen();
 
     // add the lables
+#ifdef USE_SOFTWARE_EQ
+    drawVLine(185, 0, 239, ILI9341_RED);
+    drawLabelsSelected(numItems, labelXPos, labels, selectedItem);
+    drawBandInfo();
+#else
     drawLabels(numSliders, labelXPos, labels);
+#endif
 
     // add the title
     drawTitle("Parametric Equalizer");
 
     for (uint8_t i = 0; i < numSliders; i++)
     {
-      drawSlider(sliderXPos[i], sliderYPos, sliderVal[i],  i == selectedItem ? true : false);
+      drawSlider(sliderXPos[i], sliderYPos, sliderVal[i],  i + firstSlider == selectedItem ? true : false);
     }
+
+    drawResponse(true);
   }
   else
   {
+#ifdef USE_SOFTWARE_EQ
+    // new band, all the sliders change
+    if (selectedItem == 0)
+    {
+      for (uint8_t i = 0; i < numSliders; i++)
+        drawSlider(sliderXPos[i], sliderYPos, sliderVal[i], false);
+    }
+    else
+      drawSlider(sliderXPos[selectedItem - firstSlider], sliderYPos, sliderVal[selectedItem - firstSlider], true);
+    drawBandInfo();
+#else
     // only draw selected item
     drawSlider(sliderXPos[selectedItem], sliderYPos, sliderVal[selectedItem], true);
+#endif
+
+    // redraw the curve if a band changed
+    drawResponse(false);
   }
 }
 
 
+
+// total response at each plot point, converted to
+// screen y positions. Flat when the EQ is off
+void EQ :: calcResponse()
+{
+  float power[numPlotPoints];
+  float c[5];
+  int32_t bandCoefs[5];
+
+  for (uint8_t k = 0; k < numPlotPoints; k++)
+    power[k] = 1.0;
+
+  for (uint8_t i = 0; i < numEqBands && enabled; i++)
+  {
+    // coefs are {b0, b1, b2, -a1, -a2} in fixed point
+#ifdef USE_SOFTWARE_EQ
+    if (!peq1.getCoefficients(i, bandCoefs))
+      continue;
+#else
+    if (fabsf(cfg.eqBandVals[i]) < 0.01)
+      continue;
+    peqCoefficients(bandCoefs, PEQ_PEAK, eqBandFrequencies[i], cfg.eqBandVals[i] * 12.0, eqPlotQ);
+#endif
+    for (uint8_t j = 0; j < 5; j++)
+      c[j] = bandCoefs[j] * ((float)(1 << PEQ_POST_SHIFT) / 2147483648.0);
+
+    for (uint8_t k = 0; k < numPlotPoints; k++)
+    {
+      // 20 Hz to 20 kHz, log spaced
+      float f = 20.0 * powf(1000.0, (float)k / (numPlotPoints - 1));
+      power[k] *= peqPower(c, 2.0 * PI * f / AUDIO_SAMPLE_RATE_EXACT);
+    }
+  }
+
+  // 0 dB is the middle of the plot
+  for (uint8_t k = 0; k < numPlotPoints; k++)
+  {
+    float dB = constrain(10.0 * log10f(power[k]), -plotRangedB, plotRangedB);
+    plotYPos[k] = plotY + plotHeight / 2 - (int16_t)(dB * (plotHeight / 2 - 1) / plotRangedB);
+  }
+  plotValid = true;
+}
+
+
+
+// draws the cached curve. If not drawing the whole screen, only
+// redraws when a band changed, erasing the old curve first
+void EQ :: drawResponse(bool drawAll)
+{
+  int16_t x0, x1;
+
+  if (!drawAll)
+  {
+    if (plotValid)
+      return;
+
+    for (uint8_t k = 1; k < numPlotPoints; k++)
+    {
+      x0 = plotX + (k - 1) * plotWidth / (numPlotPoints - 1);
+      x1 = plotX + k * plotWidth / (numPlotPoints - 1);
+      tft.drawLine(x0, plotYPos[k - 1], x1, plotYPos[k], GUI_FILL_COLOR);
+    }
+
+#ifndef USE_SOFTWARE_EQ
+    // the curve runs across the sliders, redraw them under it
+    for (uint8_t i = 0; i < numSliders; i++)
+      drawSlider(sliderXPos[i], sliderYPos, sliderVal[i], i == selectedItem);
+#endif
+  }
+
+  if (!plotValid)
+    calcResponse();
+
+  // 0 dB line
+  tft.drawFastHLine(plotX, plotY + plotHeight / 2, plotWidth, ILI9341_DARKGREY);
+
+  for (uint8_t k = 1; k < numPlotPoints; k++)
+  {
+    x0 = plotX + (k - 1) * plotWidth / (numPlotPoints - 1);
+    x1 = plotX + k * plotWidth / (numPlotPoints - 1);
+    tft.drawLine(x0, plotYPos[k - 1], x1, plotYPos[k], ILI9341_GREEN);
+  }
+}
+
+
+
+#ifdef USE_SOFTWARE_EQ
+// selected band's settings, top left
+void EQ :: drawBandInfo()
+{
+  const char *typeNames[3] = {"Peak", "Low Shelf", "High Shelf"};
+
+  tft.fillRect(5, 5, 175, 40, GUI_FILL_COLOR);
+  tft.setFont(Arial_12);
+  tft.setTextColor(GUI_ITEM_COLOR);
+
+  tft.setCursor(5, 5);
+  tft.print("Band ");
+  tft.print(band + 1);
+  tft.print("  ");
+  tft.print(typeNames[bandType(band)]);
+
+  tft.setTextColor(GUI_TEXT_COLOR);
+  tft.setCursor(5, 27);
+  tft.print(cfg.peqFreq[band], 0);
+  tft.print("Hz ");
+  if (cfg.peqGain[band] > 0)
+    tft.print("+");
+  tft.print(cfg.peqGain[band], 1);
+  tft.print("dB Q");
+  tft.print(cfg.peqQ[band], 1);
+}
+#endif
+
+
 bool EQ :: checkEncoders()
 {
   // checks both param & value encoders for changes.
@@ -261,7 +546,7 @@ bool EQ :: checkEncoders()
     {
       selectedItemChanged = true;
 
-      if (selectedItem < numSliders - 1)
+      if (selectedItem < numItems - 1)
         selectedItem++;
       else
         selectedItem = 0;
@@ -272,7 +557,7 @@ bool EQ :: checkEncoders()
       selectedItemChanged = true;
 
       if (selectedItem == 0)
-        selectedItem = numSliders - 1;
+        selectedItem = numItems - 1;
       else
         selectedItem--;
     }
@@ -287,17 +572,32 @@ bool EQ :: checkEncoders()
     valEncVal = readValueEncoder() / 2;
     if (valEncVal != lastValEncVal)
     {
+#ifdef USE_SOFTWARE_EQ
+      if (selectedItem == 0)
+      {
+        // band select
+        if (valEncVal > lastValEncVal && band < numEqBands - 1)
+          band++;
+        else if (valEncVal < lastValEncVal && band > 0)
+          band--;
+        itemValueChanged = true;
+        printValue("band", band);
+        return itemValueChanged;
+      }
+#endif
+      uint8_t s = selectedItem - firstSlider;
+
       // increase or decrease the slider's new position (need to re-draw later)
       if (valEncVal > lastValEncVal)
-        sliderVal[selectedItem] += 4;
+        sliderVal[s] += 4;
 
       else if (valEncVal < lastValEncVal)
-        sliderVal[selectedItem] -= 4;
+        sliderVal[s] -= 4;
 
       // keep it in the slider's range
-      sliderVal[selectedItem] = constrain(sliderVal[selectedItem], 0, 100.0);
+      sliderVal[s] = constrain(sliderVal[s], 0, 100.0);
       itemValueChanged = true;
-      printValue("sliderVal[selectedItem]", sliderVal[selectedItem]);
+      printValue("sliderVal[selectedItem]", sliderVal[s]);
       return itemValueChanged;
     }
     return false;
@@ -250,7 +250,7 @@ void Flanger :: process(bool initScreen)
 
 
   // allow some time for user to rotate encoders
-  delay(50);
+  idleDelay(50);
 
   // read encoders and check for changes
   checkEncoders();
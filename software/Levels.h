@@ -12,6 +12,12 @@
    and red indicates saturation (which sounds really bad on
    a DSP based system).
 
+   Next to each bargraph is the RMS level in dBFS and the
+   short-term (3 sec) loudness in LUFS, from the loudness
+   analyzers (analyze_loudness.h). Use the LUFS to match the
+   output level between settings, peaks don't tell you how
+   loud it sounds.
+
    Ref values:
    Input Level Adj: 16 levels with 0 being max;
           0: 3.12 Volts p-p      8: 0.79 Volts p-p
@@ -68,6 +74,7 @@ class Levels {
     float calcEqAdjustment();
     void drawScreen(bool);
     void drawVU(int16_t, int16_t, float);
+    void drawReadouts(int16_t, float, float);
 
     bool selectedItemChanged;
     bool itemValueChanged;
@@ -91,6 +98,11 @@ class Levels {
 
     float inputPeak;
     float outputPeak;
+
+    // rms & loudness readouts, updated 4 times a sec
+    static const uint16_t readoutMs = 250;
+    elapsedMillis readoutTime;
+    float loudness[numVUs];
 };
 
 
@@ -102,6 +114,7 @@ Levels :: Levels()
   lastselectedItem = 0;
   selectedItemChanged = false;
   itemValueChanged = false;
+  loudness[0] = loudness[1] = LOUDNESS_FLOOR;
 }
 
 
@@ -142,11 +155,19 @@ float Levels :: calcEqAdjustment()
   float eqAdjust = 0;
 
   // find the largest eq value adjustment
+#ifdef USE_SOFTWARE_EQ
+  for (uint8_t i = 0; i < NUM_PEQ_BANDS; i++)
+  {
+    if (cfg.peqGain[i] > eqAdjust)
+      eqAdjust = cfg.peqGain[i];
+  }
+#else
   for (uint8_t i = 0; i < NUM_EQ_BANDS; i++)
   {
     if (cfg.eqBandVals[i] > eqAdjust)
       eqAdjust = cfg.eqBandVals[i];
   }
+#endif
 
   eqAdjust = exp10(eqAdjust / 20.0);
   return eqAdjust;
@@ -274,6 +295,42 @@ void Levels :: drawScreen(bool drawAll)
     outputPeak *= 0.92;
 
   drawVU(vuPosX[1], vuPosY[1], outputPeak);
+
+  // rms & loudness, text is slow to draw so not every time
+  if (drawAll || readoutTime >= readoutMs)
+  {
+    readoutTime = 0;
+    if (loud1.available())
+      loudness[0] = loud1.readLoudness();
+    if (loud2.available())
+      loudness[1] = loud2.readLoudness();
+
+    drawReadouts(vuPosX[0] + 34, loud1.readRMS(), loudness[0]);
+    drawReadouts(vuPosX[1] + 34, loud2.readRMS(), loudness[1]);
+  }
+}
+
+
+
+// rms & loudness to the right of a bargraph
+void Levels :: drawReadouts(int16_t xPos, float rms, float lufs)
+{
+  tft.setFont(Arial_10);
+
+  tft.setTextColor(GUI_ITEM_COLOR);
+  tft.setCursor(xPos, 20);
+  tft.print("RMS");
+  tft.setCursor(xPos, 80);
+  tft.print("LUFS");
+
+  tft.setTextColor(GUI_TEXT_COLOR);
+  tft.fillRect(xPos, 36, 50, 14, GUI_FILL_COLOR);
+  tft.setCursor(xPos, 36);
+  tft.print(rms, 1);
+
+  tft.fillRect(xPos, 96, 50, 14, GUI_FILL_COLOR);
+  tft.setCursor(xPos, 96);
+  tft.print(lufs, 1);
 }
 
 
@@ -0,0 +1,236 @@
+/**********************************************************
+   Looper Class
+   Phrase looper with overdub & undo, recorded into the
+   external SRAM it shares with the delay (see sram.h).
+   Only built with USE_LOOPER.
+
+   Played from a footswitch on a second PCF8574 at
+   FOOTSWITCH_ADDRESS, wired the same way as the front
+   panel, buttons & leds both active low:
+
+     button 0   record / overdub   led 4  recording
+     button 1   play / stop        led 5  overdubbing
+     button 2   undo / redo        led 6  playing
+     button 3   clear              led 7  undo available
+
+   The first press of record closes the loop on the next
+   press, or on play. Pressing any footswitch turns the
+   looper on.
+
+   What's recorded is the output mix, dry & wet at the mix
+   pot setting, so the loop sounds like what was played.
+
+    Version 1.0     Oct 2026
+
+   Audio chain:
+   Mixer1 (dry) ---|-> Mixer6 -> Looper1 -> Mixer4 -> I2SOut
+   Mixer8_1 (wet) -|
+
+ * **************************************************************/
+
+#ifndef LOOPER_H
+#define LOOPER_H
+
+#ifdef USE_LOOPER
+
+
+AudioMixer4              mixer6;
+AudioEffectLooper        looper1(SRAM_LOOPER_BEGIN, SRAM_LOOPER_SAMPLES);
+
+AudioConnection          loopDryCord(mixer1, 0, mixer6, DRY_OUT);
+AudioConnection          loopWetCord(mixer8_1, 0, mixer6, WET_OUT);
+AudioConnection          loopInCord(mixer6, 0, looper1, 0);
+AudioConnection          loopOutCord(looper1, 0, mixer4, LOOP_OUT);
+
+PCF8574 footswitch(FOOTSWITCH_ADDRESS);
+
+
+
+class Looper {
+  public:
+    Looper();
+    void init();
+    void disable();
+    void enable();
+    void toggle();
+    bool getStatus();
+    void printConfig();
+    void update();
+    void poll();
+    bool enabled;
+
+  private:
+    static const uint8_t pollMs = 5;
+
+    bool connected;
+    elapsedMillis pollTime;
+    uint8_t lastButtons;
+    uint8_t lastLeds;
+
+    void updateFootswitchLEDs();
+};
+
+
+
+
+// this is run before audio board is initialized
+Looper :: Looper()
+{
+  enabled = false;
+  connected = false;
+  lastButtons = 0;
+  lastLeds = 0xff;
+}
+
+
+
+// run after audio board is initialized
+void Looper :: init()
+{
+  pinMode(SRAM_CS_PIN, OUTPUT);
+  digitalWrite(SRAM_CS_PIN, HIGH);
+
+  // buttons are inputs when written high
+  footswitch.begin();
+  connected = footswitch.isConnected();
+  if (connected)
+    footswitch.write8(0xff);
+  else
+    printValue("no looper footswitch");
+
+  disable();
+  printValue("looper initialized");
+}
+
+
+
+// mutes & stops the loop, it's kept unless recording
+void Looper :: disable()
+{
+  uint8_t state = looper1.state();
+
+  memProfileSample();
+  if (state == LOOP_RECORDING)
+    looper1.command(LOOP_CMD_CLEAR);
+  else if (state == LOOP_PLAYING || state == LOOP_OVERDUBBING)
+    looper1.command(LOOP_CMD_PLAY);
+
+  mixer4.gain(LOOP_OUT, 0);
+  enabled = false;
+  printValue("looper disabled");
+}
+
+
+
+void Looper :: enable()
+{
+  mixer4.gain(LOOP_OUT, cfg.looperVolume);
+  enabled = true;
+  printValue("looper enabled");
+}
+
+
+
+void Looper :: toggle()
+{
+  if (enabled)
+    disable();
+  else
+    enable();
+}
+
+
+
+bool Looper :: getStatus()
+{
+  return enabled;
+}
+
+
+
+void Looper :: printConfig()
+{
+  Serial.print("Looper Enabled  = "); Serial.println(enabled);
+  Serial.print("Looper Volume   = "); Serial.println(cfg.looperVolume);
+  Serial.print("Looper Max Secs = "); Serial.println(SRAM_LOOPER_SAMPLES / AUDIO_SAMPLE_RATE_EXACT);
+  Serial.print("Loop Length     = "); Serial.println(looper1.length() / AUDIO_SAMPLE_RATE_EXACT);
+  Serial.print("Footswitch      = "); Serial.println(connected);
+}
+
+
+
+void Looper :: update()
+{
+  if (enabled)
+    enable();
+  else
+    disable();
+  printValue("Looper Settings Updated");
+}
+
+
+
+// called from idle(), so presses during screen delays &
+// messages are seen. Sends a command for each button
+// pressed, in button order if more than one.
+void Looper :: poll()
+{
+  if (!connected || pollTime < pollMs)
+    return;
+  pollTime = 0;
+
+  // buttons inverted, pressed = 1 here
+  uint8_t buttons = ~footswitch.read8() & 0x0f;
+  uint8_t pressed = buttons & ~lastButtons;
+  lastButtons = buttons;
+
+  if (pressed)
+  {
+    memProfileSample();
+    if (!enabled)
+    {
+      enable();
+      updateLEDs();
+    }
+
+    if (pressed & (1 << LOOP_RECORD_SWITCH))
+      looper1.command(LOOP_CMD_RECORD);
+    if (pressed & (1 << LOOP_PLAY_SWITCH))
+      looper1.command(LOOP_CMD_PLAY);
+    if (pressed & (1 << LOOP_UNDO_SWITCH))
+      looper1.command(LOOP_CMD_UNDO);
+    if (pressed & (1 << LOOP_CLEAR_SWITCH))
+      looper1.command(LOOP_CMD_CLEAR);
+  }
+
+  updateFootswitchLEDs();
+}
+
+
+
+// only written when they change
+void Looper :: updateFootswitchLEDs()
+{
+  uint8_t state = looper1.state();
+  uint8_t leds = 0;
+
+  if (state == LOOP_RECORDING)
+    leds |= 1 << LOOP_RECORD_LED;
+  if (state == LOOP_OVERDUBBING)
+    leds |= 1 << LOOP_DUB_LED;
+  if (state == LOOP_PLAYING || state == LOOP_OVERDUBBING)
+    leds |= 1 << LOOP_PLAY_LED;
+  if (looper1.canUndo())
+    leds |= 1 << LOOP_UNDO_LED;
+
+  // leds inverted, keep the button bits high
+  leds = ~leds | 0x0f;
+  if (leds != lastLeds)
+  {
+    footswitch.write8(leds);
+    lastLeds = leds;
+  }
+}
+
+#endif
+#endif
@@ -0,0 +1,129 @@
+/**********************************************************
+   Noise Gate Class
+
+   Interface for the noise gate ahead of the effects chain.
+   There is no GUI for the gate, it is on at startup and can
+   be toggled from the serial port. It mutes the input
+   between notes so the high gain effects (delay, reverb)
+   don't amplify hiss and the high freq noise (see known
+   bug #3).
+
+   version 1.0   Oct 2026
+
+   adjustments:
+       threshold: gate opens above this level, -96 to 0 dBFS
+       hysteresis: closes this many dB below threshold
+       hold: stays open after level drops, in ms
+       release: fade out time, in ms
+
+   Audio chain:
+   I2SIn -> Gate1 -> Mixer1 -> Effects -> I2SOut
+
+ * **************************************************************/
+
+#ifndef NOISE_GATE_H
+#define NOISE_GATE_H
+
+
+
+class NoiseGate {
+  public:
+    NoiseGate();
+    void init();
+    void disable();
+    void enable();
+    void toggle();
+    bool getStatus();
+    void printConfig();
+    void setValues(float t, float h, float hold, float r);
+    void update();
+    bool enabled;
+};
+
+
+
+// this is run before audio board is initialized
+NoiseGate :: NoiseGate()
+{
+  // nothing to do
+}
+
+
+
+// run after audio board is initialized
+void NoiseGate :: init()
+{
+  update();
+  enable();
+  printValue("Noise Gate initialized");
+}
+
+
+
+void NoiseGate :: disable()
+{
+  gate1.setBypass(true);
+  enabled = false;
+  printValue("Noise Gate disabled");
+}
+
+
+
+void NoiseGate :: enable()
+{
+  gate1.setBypass(false);
+  enabled = true;
+  printValue("Noise Gate enabled");
+}
+
+
+
+void NoiseGate :: toggle()
+{
+  if (enabled)
+    disable();
+  else
+    enable();
+}
+
+
+
+bool NoiseGate :: getStatus()
+{
+  return enabled;
+}
+
+
+
+void NoiseGate :: setValues(float t, float h, float hold, float r)
+{
+  cfg.gateThreshold  = t;
+  cfg.gateHysteresis = h;
+  cfg.gateHold       = hold;
+  cfg.gateRelease    = r;
+  update();
+}
+
+
+
+void NoiseGate :: printConfig()
+{
+  Serial.print(F("Gate Enabled   = "));   Serial.println(enabled);
+  Serial.print(F("Gate Threshold = "));   Serial.println(cfg.gateThreshold);
+  Serial.print(F("Gate Hysteresis= "));   Serial.println(cfg.gateHysteresis);
+  Serial.print(F("Gate Hold      = "));   Serial.println(cfg.gateHold);
+  Serial.print(F("Gate Release   = "));   Serial.println(cfg.gateRelease);
+}
+
+
+
+// does the actual changes to the audio board
+void NoiseGate :: update()
+{
+  gate1.threshold(cfg.gateThreshold, cfg.gateHysteresis);
+  gate1.hold(cfg.gateHold);
+  gate1.release(cfg.gateRelease);
+  printValue("Noise Gate Settings Updated");
+}
+
+#endif
@@ -195,7 +195,7 @@ void Reverb :: process(bool initScreen)
 
 
   // allow some time for user to rotate encoders
-  delay(50);
+  idleDelay(50);
 
   // read encoders and check for changes
   checkEncoders();
@@ -64,8 +64,10 @@
     known bugs & todo:
     1) Hang on boot: seems to be a conflict between LCD and audio board serial flash that
     causes an intermittant hang on boot. Startup sequence rearranged, seems better but not fixed.
-    2) Compressor - bug in teensy audio lib, see pull #210, manually applied
-    3) High freq noise under some condtions - seems to be coupled through USB
+    2) Compressor - bug in teensy audio lib, see pull #210, manually applied.
+    Software compressor (USE_SOFTWARE_COMPRESSOR) no longer needs the patched lib.
+    3) High freq noise under some condtions - seems to be coupled through USB.
+    Noise gate (NoiseGate.h) now mutes the input between notes.
     todo: decide if current values are kept in cfg.xxx or in the class (probably class)
     i.e. the config code is now somewhat dated.
     todo: test compressor now that bug in lib is patched.
@@ -96,6 +98,23 @@ bool debugPrint = true;
 // jump to setting when effects selected
 //#define SHOW_EFFECTS_SETTINGS
 
+// use the software compressor node instead of the SGTL5000 compressor
+#define USE_SOFTWARE_COMPRESSOR
+
+// use the 8 band parametric EQ node instead of the SGTL5000 graphic EQ
+#define USE_SOFTWARE_EQ
+
+// MIDI program change & CC control, needs USB Type 'Serial + MIDI'
+//#define USE_USB_MIDI
+
+// audio memory blocks, the 'A' command reports the smallest
+// safe size for the effects used (memprofile.h)
+#define AUDIO_MEMORY_BLOCKS  256
+
+// looper in the external SRAM with a footswitch, the delay
+// keeps 500ms of the SRAM (see sram.h)
+//#define USE_LOOPER
+
 
 // audio patchpanel from audio tool
 #include "patches.h"
@@ -107,14 +126,38 @@ bool debugPrint = true;
 #include "hardware.h"   // hardware connections
 
 
+// number of menus
+#define NUM_MENUS       10
+
+// order of effect screens
+#define EQ_SCREEN          0
+#define COMPRESSOR_SCREEN  1
+#define TREMOLO_SCREEN     2
+#define REVERB_SCREEN      3
+#define FLANGER_SCREEN     4
+#define DELAY_SCREEN       5
+#define CHORUS_SCREEN      6
+#define SHAPER_SCREEN      7
+#define INPUT_SCREEN       8
+#define ANALYZER_SCREEN    9
+#define STATUS_SCREEN      10
+#define TUNER_SCREEN       11
+#define LIBRARY_SCREEN     12
+
+
+
 // prototypes
 void adjustMixValue();
 void adjustWahWahValue();
-void startGuitarTuner();
 void playTone();
 void printConfig();
 void printStatus();
+void printClipReport();
+void printDropoutReport();
 void doSerialCommands();
+void doSerialCommand(char c);
+void updateLEDs();
+void memProfileSample();
 
 
 
@@ -127,7 +170,12 @@ void doSerialCommands();
 #include "Tremolo.h"
 #include "WahWah.h"
 #include "Chorus.h"
+#include "Waveshaper.h"
+#include "NoiseGate.h"
 #include "Levels.h"
+#include "Analyzer.h"
+#include "tuner.h"
+#include "Looper.h"
 
 
 // create instances of effects
@@ -139,28 +187,40 @@ Tremolo tremolo;
 Flanger flanger;
 WahWah wahwah;
 Chorus chorus;
+Waveshaper waveshaper;
+NoiseGate noiseGate;
 Levels levels;
+Analyzer analyzer;
+Tuner tuner;
+#ifdef USE_LOOPER
+Looper looper;
+#endif
 
 // include after declaring classes
 #include "status.h"     // status screen
-#include "tuner.h"
 #include "update.h"
+#include "benchmark.h"
+#include "pedal.h"      // wah-wah pedal
+#include "usbaudio.h"   // usb sound card
+#include "recorder.h"   // sd card recorder
+
+Pedal pedal;
+#ifdef AUDIO_INTERFACE
+UsbAudio usbAudio;
+#endif
+#ifdef USE_SD_CARD
+Recorder recorder;
+#endif
 
+#include "protocol.h"   // binary serial protocol & params
+#include "presets.h"    // presets in eeprom
+#include "library.h"    // presets on the sd card
+#include "memprofile.h" // audio memory by effects
+#include "console.h"    // set / get / list line commands
+#include "midi.h"       // usb midi control
 
-
-// number of menus
-#define NUM_MENUS       8
-
-// order of effect screens
-#define EQ_SCREEN          0
-#define COMPRESSOR_SCREEN  1
-#define TREMOLO_SCREEN     2
-#define REVERB_SCREEN      3
-#define FLANGER_SCREEN     4
-#define DELAY_SCREEN       5
-#define CHORUS_SCREEN      6
-#define INPUT_SCREEN       7
-#define STATUS_SCREEN      8
+Protocol protocol;
+MemProfile memProfile;
 
 
 
@@ -170,14 +230,12 @@ uint8_t lastMenuIndex = 0;
 uint32_t menuChangedTime = 0;
 boolean initScreen = true;
 boolean msgFlag = false;
-uint8_t tunerMode = 0;
 
 // button timer
 uint32_t lastTime;
 
 // pot values
 int mixPot;
-int wahWahPot;
 
 
 
@@ -231,8 +289,8 @@ void setup()
 
   printValue("Configuring Audio...");
 
-  // allocate memory for audio (mostly for delays)
-  AudioMemory(256);
+  // allocate memory for audio, the delay uses the SRAM
+  AudioMemory(AUDIO_MEMORY_BLOCKS);
 
   // Enable the audio shield and set the output volumes
   printValue("Enabling audio module");
@@ -261,11 +319,28 @@ void setup()
   flanger.init();
   wahwah.init();
   chorus.init();
+  waveshaper.init();
+  noiseGate.init();
   levels.init();
+  analyzer.init();
+  tuner.init();
+#ifdef USE_LOOPER
+  looper.init();
+#endif
+#ifdef AUDIO_INTERFACE
+  usbAudio.init();
+#endif
+#ifdef USE_SD_CARD
+  recorder.init();
+  library.init();
+#endif
+#ifdef USE_USB_MIDI
+  midi.init();
+#endif
 
   // configure a sine wave for the test tone and disable
   sine2.frequency(500);   // 500 Hz
-  sine2.amplitude(0.5);   // 50% amplitude
+  testTone(false);
 
   // initialize encoders
   paramEncoder.write(0);
@@ -282,9 +357,12 @@ void setup()
   }
 
 
-  // update all global audio settings
+  // update all global audio settings, the pots are read so
+  // start them first
+  initPots();
   updateMix(readMixPot());
   updateWahWah(readWahWahPot());
+  pedal.init();
   updateAudio();
 
   // fire up the lcd screen
@@ -322,8 +400,18 @@ void loop()
   uint8_t switchPressed;
   String message;
 
-  // slow loop down just a bit
-  delay(50);
+  // slow loop down just a bit, keeping the tuner strobe moving
+  elapsedMillis loopTime;
+  while (loopTime < 50)
+  {
+    tuner.animate();
+    idle();
+    protocol.poll();
+    memProfile.poll();
+#ifdef USE_USB_MIDI
+    midi.poll();
+#endif
+  }
 
   // blink test led to show we're alive
   if (millis() - lastTime > 1000)
@@ -337,7 +425,9 @@ void loop()
   if (saveSwitch.fallingEdge())
   {
     printValue("Save Button Pressed");
+    dropout1.activityStart(ACT_EEPROM);
     saveConfig();
+    dropout1.activityEnd(ACT_EEPROM);
     message = "Config Saved";
     msgFlag = true;
   }
@@ -347,9 +437,25 @@ void loop()
   if (tunerSwitch.fallingEdge())
   {
     if (debugPrint) Serial.println("Tuner Button Presssed");
-    startGuitarTuner();
+
+    // open the tuner screen, or go back to the last menu
+    if (tuner.active)
+      menuIndex = cfg.lastMenu;
+    else
+      menuIndex = TUNER_SCREEN;
   }
 
+  // collect tuner readings
+  tuner.update();
+
+  // for the dropout log
+  dropout1.setEffects(effectsMask());
+
+#ifdef USE_USB_MIDI
+  // apply the midi messages received
+  midi.process();
+#endif
+
 
   // read front panel pots
   mixPot = readMixPot();
@@ -357,16 +463,11 @@ void loop()
     updateMix(mixPot);
 
 
-  // read wah-wah pot
-  wahWahPot = readWahWahPot();
-  if (abs(wahWahPot - lastWahWahPot) > 3)
-    updateWahWah(wahWahPot);
-
-
   // Read the front panel buttons
   switchPressed = readButtons();
   if (switchPressed)
   {
+    memProfileSample();
     switch (switchPressed)
     {
       case 0x01:  // Reverb switch
@@ -444,9 +545,20 @@ void loop()
     initScreen = true;
     resetEncoders();
     menuChangedTime = millis();
+
+    // leaving the analyzer, disconnect its FFTs
+    if (lastMenuIndex == ANALYZER_SCREEN)
+      analyzer.close();
+
+    // leaving the tuner, stop it & unmute
+    if (lastMenuIndex == TUNER_SCREEN)
+      tuner.close();
+
     lastMenuIndex = menuIndex;
   }
 
+  // the screen's drawing, its wait in idleDelay() isn't tagged
+  dropout1.activityStart(ACT_SCREEN);
   switch (menuIndex)
   {
     case EQ_SCREEN:
@@ -481,13 +593,32 @@ void loop()
       chorus.process(initScreen);
       break;
 
+    case SHAPER_SCREEN:
+      waveshaper.process(initScreen);
+      break;
+
+    case ANALYZER_SCREEN:
+      analyzer.process(initScreen);
+      break;
+
     case STATUS_SCREEN:
       statusScreen(initScreen);
       break;
 
+    case TUNER_SCREEN:
+      tuner.process(initScreen);
+      break;
+
+#ifdef USE_SD_CARD
+    case LIBRARY_SCREEN:
+      library.process(initScreen);
+      break;
+#endif
+
     default:
       printValue("Error: Invalid Screen Selection", menuIndex);
   }
+  dropout1.activityEnd(ACT_SCREEN);
 
   initScreen = false;
 
@@ -517,12 +648,19 @@ void loop()
 
     // touched center - go to status screen
     else
+    {
       menuIndex = STATUS_SCREEN;
+#ifdef USE_SD_CARD
+      // and from there to the preset library
+      if (lastMenuIndex == STATUS_SCREEN)
+        menuIndex = LIBRARY_SCREEN;
+#endif
+    }
 
     cfg.lastMenu = menuIndex;
 
     // add a delay after touch detected
-    delay(100);
+    idleDelay(100);
   }
 
 
@@ -555,6 +693,31 @@ void loop()
 
 
 
+// before the effects, tuner, analyzer, recorder or looper
+// change (memprofile.h)
+void memProfileSample()
+{
+  memProfile.sample();
+}
+
+
+
+// things that have to be polled more often than the main
+// loop runs, also called from idleDelay() while a screen
+// waits or shows a message
+void idle()
+{
+  pedal.poll();
+#ifdef USE_LOOPER
+  looper.poll();
+#endif
+#ifdef USE_SD_CARD
+  recorder.poll();
+#endif
+}
+
+
+
 void updateLEDs()
 {
   setLED(REVERB_LED,  reverb.getStatus());
@@ -576,58 +739,13 @@ void printPoint(TS_Point p)
 
 
 
-void startGuitarTuner()
-{
-  // Disable all effects to minimize memory and cpu usage
-  compressor.disable();
-  flange1.voices(0, 0, 0);
-
-  // enable inputs, not tone or delay feedback
-  mixer1.gain(LEFT_IN, 1.0);
-  mixer1.gain(TEST_TONE, 0);
-
-  // turn off effects and enable dry
-  mixer8_1.gain(REVERB_IN, 0);
-  mixer8_1.gain(CHORUS_IN, 0);
-  mixer8_1.gain(WAH_WAH_IN, 0);
-  mixer8_1.gain(FLANGER_IN, 0);
-  mixer8_1.gain(TREMOLO_IN, 0);
-  mixer8_1.gain(DELAY_IN, 0);
-
-
-  // launch the guitar tuner
-  guitarTuner();
-
-  // restart flanger
-  flanger.init();
-
-  // reset compressor
-  if (cfg.compEnabled)
-    compressor.enable();
-
-  // read current pot settings
-  mixPot = readMixPot();
-  wahWahPot = readWahWahPot();
-
-  // set audio controls back to current values
-  updateMix(mixPot);
-  updateWahWah(wahWahPot);
-  updateAudio();
-
-  // go to menu screen
-  initScreen = true;
-  menuIndex = cfg.lastMenu;
-}
-
-
-
 void playTone()
 {
   // enable mixer channel & leave on for now
   printValue("Playing Tone");
-  mixer1.gain(TEST_TONE, 1.0);
+  testTone(true);
   delay(120);
-  mixer1.gain(TEST_TONE, 0);
+  testTone(false);
   printValue("done");
 }
 
@@ -638,7 +756,7 @@ void playLongTone()
   // enable mixer channel & leave on for now
   printValue("Playing Tone");
 
-  mixer1.gain(TEST_TONE, 1.0);
+  testTone(true);
 
   // read pots and buttons while playing tone
   for (int j = 0; j < 50; j++)
@@ -646,143 +764,262 @@ void playLongTone()
     loop();
     delay(100);
   }
-  mixer1.gain(TEST_TONE, 0);
+  testTone(false);
   printValue("done");
 }
 
 
 
 
+// console line being typed
+char consoleLine[CONSOLE_LINE_LENGTH];
+uint8_t consoleLineLen = 0;
+elapsedMillis consoleLineTime;
+
+
+
+// a line command, or a single letter command on its own. A
+// longer line that isn't a command is refused, so a typo
+// doesn't run each of its letters
+void runConsoleLine()
+{
+  char words[CONSOLE_LINE_LENGTH];
+
+  consoleLine[consoleLineLen] = 0;
+  strcpy(words, consoleLine);
+  consoleLineLen = 0;
+
+  if (doLineCommand(words))
+    return;
+
+  // without spaces around it
+  char *cmd = consoleLine;
+  while (*cmd == ' ' || *cmd == '\t')
+    cmd++;
+  uint8_t len = strlen(cmd);
+  while (len && (cmd[len - 1] == ' ' || cmd[len - 1] == '\t'))
+    len--;
+
+  if (len == 1)
+    doSerialCommand(cmd[0]);
+  else if (len > 1)
+    consoleError("unknown command", "");
+}
+
+
+
 void doSerialCommands()
 {
-  // check for incoming data on serial port
-  if (Serial.available())
+  // binary frames first, then collect a line of text
+  protocol.poll();
+  while (Serial.available() && Serial.peek() != PROTO_SYNC)
   {
-    // read 1st character, preserving the rest
     char c = Serial.read();
+    consoleLineTime = 0;
 
-    // filter out non-printable characters
-    if (c > 32 && c < 127)
+    if (c == '\n' || c == '\r')
     {
-      Serial.print("Serial Cmd ->"); Serial.println(c);
-
-      switch (c)
-      {
-        case 'p':
-          printConfig();
-          break;
-
-        case 'm':
-          printAudioMemUsage();
-          break;
-
-        case 's':
-          printStatus();
-          break;
-
-        case 'M':
-          menuIndex++;
-          if (menuIndex > NUM_MENUS - 1 )
-            menuIndex = 0;
-          break;
-
-        case 't':
-          playTone();
-          break;
-
-        case 'l':
-          playLongTone();
-          break;
-
-        case 'R':
-          reverb.toggle();
-          updateLEDs();
-          break;
-
-        case 'T':
-          tremolo.toggle();
-          updateLEDs();
-          break;
-
-        case 'F':
-          flanger.toggle();
-          updateLEDs();
-          break;
-
-        case 'W':
-          wahwah.toggle();
-          updateLEDs();
-          break;
-
-        case 'C':
-          compressor.toggle();
-          break;
-
-        case 'E':
-          eq.toggle();
-          break;
-
-        case 'D':
-          delayer.toggle();
-          break;
-
-        case 'c':
-          chorus.toggle();
-          break;
-
-        case 'd':
-          // toggle delay recirculate
-          if (delayer.getRecirculate() > 0)
-            delayer.setRecirculate(0);
-          else
-            delayer.setRecirculate(0.4);
-          delayer.process(true);
-          break;
-
-        case '!':
-          reverb.disable();
-          flanger.disable();
-          tremolo.disable();
-          wahwah.disable();
-          delayer.disable();
-          compressor.disable();
-          chorus.disable();
-          eq.disable();
-          break;
-
-        case '$':
-          clearEEPROM();
-          break;
-
-        case '?':
-          Serial.println(F("p: Print config"));
-          Serial.println(F("m: print Memory usage"));
-          Serial.println(F("s: print effects Status"));
-          Serial.println(F("t: play test Tone"));
-          Serial.println(F("l: play long test Tone"));
-          Serial.println(F("M: Move to next screen"));
-
-          Serial.println(F("C: toggle Compressor"));
-          Serial.println(F("E: toggle Equalizer"));
-          Serial.println(F("R: toggle Reverb"));
-          Serial.println(F("F: toggle Flanger"));
-          Serial.println(F("T: toggle Tremolo"));
-          Serial.println(F("W: toggle WahWah"));
-          Serial.println(F("D: toggle Delayer"));
-          Serial.println(F("c: toggle Chorus"));
-
-          Serial.println(F("d: toggle Delay Recirculate"));
-
-          Serial.println(F("!: Reset All Effects"));
-          Serial.println(F("$: Clear EEPROM"));
-
-          Serial.println(F("?: print help"));
-          Serial.println();
-          break;
-
-        default:
-          Serial.println(F("I'm sorry Dave, I afraid I can't do that"));
-      }
+      if (consoleLineLen)
+        runConsoleLine();
+    }
+    else if (c >= 32 && c < 127 && consoleLineLen < CONSOLE_LINE_LENGTH - 1)
+      consoleLine[consoleLineLen++] = c;
+  }
+
+  // no line ending sent
+  if (consoleLineLen && consoleLineTime > CONSOLE_TIMEOUT)
+    runConsoleLine();
+}
+
+
+
+void doSerialCommand(char c)
+{
+  // filter out non-printable characters
+  if (c > 32 && c < 127)
+  {
+    Serial.print("Serial Cmd ->"); Serial.println(c);
+    memProfileSample();
+
+    switch (c)
+    {
+      case 'p':
+        printConfig();
+        break;
+
+      case 'm':
+        printAudioMemUsage();
+        break;
+
+      case 's':
+        printStatus();
+        break;
+
+      case 'M':
+        menuIndex++;
+        if (menuIndex > NUM_MENUS - 1 )
+          menuIndex = 0;
+        break;
+
+      case 't':
+        playTone();
+        break;
+
+      case 'l':
+        playLongTone();
+        break;
+
+      case 'R':
+        reverb.toggle();
+        updateLEDs();
+        break;
+
+      case 'T':
+        tremolo.toggle();
+        updateLEDs();
+        break;
+
+      case 'F':
+        flanger.toggle();
+        updateLEDs();
+        break;
+
+      case 'W':
+        wahwah.toggle();
+        updateLEDs();
+        break;
+
+      case 'C':
+        compressor.toggle();
+        break;
+
+      case 'E':
+        eq.toggle();
+        break;
+
+      case 'D':
+        delayer.toggle();
+        break;
+
+      case 'c':
+        chorus.toggle();
+        break;
+
+      case 'S':
+        waveshaper.toggle();
+        break;
+
+      case 'G':
+        noiseGate.toggle();
+        break;
+
+      case 'd':
+        // toggle delay recirculate
+        if (delayer.getRecirculate() > 0)
+          delayer.setRecirculate(0);
+        else
+          delayer.setRecirculate(0.4);
+        delayer.process(true);
+        break;
+
+      case '!':
+        reverb.disable();
+        flanger.disable();
+        tremolo.disable();
+        wahwah.disable();
+        delayer.disable();
+        compressor.disable();
+        chorus.disable();
+        waveshaper.disable();
+        eq.disable();
+        break;
+
+      case 'b':
+        runBenchmarks();
+        break;
+
+      case 'i':
+        measureIdleCpu();
+        break;
+
+      case 'o':
+        printClipReport();
+        break;
+
+      case 'u':
+        menuIndex = tuner.active ? cfg.lastMenu : TUNER_SCREEN;
+        break;
+
+      case 'P':
+        pedal.calibrate();
+        break;
+
+      case 'A':
+        memProfile.report();
+        break;
+
+      case 'x':
+        printDropoutReport();
+        break;
+
+#ifdef USE_SD_CARD
+      case 'r':
+        recorder.toggle();
+        break;
+#endif
+
+      case '$':
+        clearEEPROM();
+        break;
+
+      case '?':
+        Serial.println(F("p: Print config"));
+        Serial.println(F("m: print Memory usage"));
+        Serial.println(F("s: print effects Status"));
+        Serial.println(F("t: play test Tone"));
+        Serial.println(F("l: play long test Tone"));
+        Serial.println(F("M: Move to next screen"));
+
+        Serial.println(F("C: toggle Compressor"));
+        Serial.println(F("E: toggle Equalizer"));
+        Serial.println(F("R: toggle Reverb"));
+        Serial.println(F("F: toggle Flanger"));
+        Serial.println(F("T: toggle Tremolo"));
+        Serial.println(F("W: toggle WahWah"));
+        Serial.println(F("D: toggle Delayer"));
+        Serial.println(F("c: toggle Chorus"));
+        Serial.println(F("S: toggle waveShaper"));
+        Serial.println(F("G: toggle noise Gate"));
+
+        Serial.println(F("d: toggle Delay Recirculate"));
+
+        Serial.println(F("!: Reset All Effects"));
+        Serial.println(F("$: Clear EEPROM"));
+        Serial.println(F("b: run Benchmarks"));
+        Serial.println(F("i: measure Idle cpu"));
+        Serial.println(F("o: print clipping (Overload) report"));
+        Serial.println(F("u: toggle tUner"));
+        Serial.println(F("P: calibrate wah-wah Pedal"));
+        Serial.println(F("A: Audio memory profile"));
+        Serial.println(F("x: print dropout (Xrun) log"));
+#ifdef USE_SD_CARD
+        Serial.println(F("r: start / stop sd card Recording"));
+#endif
+
+        Serial.println(F("set <param> <value> ...: change settings"));
+        Serial.println(F("get <param> ...: print settings"));
+        Serial.println(F("list [prefix]: print settings & ranges"));
+        Serial.println(F("store <n> / recall <n>: save / load preset"));
+#ifdef USE_SD_CARD
+        Serial.println(F("lib [save|load <name>]: sd card preset library"));
+#endif
+
+        Serial.println(F("?: print help"));
+        Serial.println();
+        break;
+
+      default:
+        Serial.println(F("I'm sorry Dave, I afraid I can't do that"));
     }
   }
 }
@@ -804,7 +1041,21 @@ void printConfig()
   flanger.printConfig();
   levels.printConfig();
   chorus.printConfig();
+  waveshaper.printConfig();
+  noiseGate.printConfig();
   wahwah.printConfig();
+  pedal.printConfig();
+#ifdef USE_LOOPER
+  looper.printConfig();
+#endif
+#ifdef AUDIO_INTERFACE
+  usbAudio.printConfig();
+#endif
+#ifdef USE_SD_CARD
+  recorder.printConfig();
+  library.printConfig();
+#endif
+  tuner.printConfig();
 
   Serial.print(F("Last Menu  = ")); Serial.println(cfg.lastMenu);
   Serial.println();
@@ -823,4 +1074,56 @@ void printStatus()
   Serial.print(F("Tremolo enabled    = ")); Serial.println(tremolo.getStatus());
   Serial.print(F("Chorus enabled     = ")); Serial.println(chorus.getStatus());
   Serial.print(F("Wah-Wah enabled    = ")); Serial.println(wahwah.getStatus());
+  Serial.print(F("Shaper enabled     = ")); Serial.println(waveshaper.getStatus());
+  Serial.print(F("Noise Gate enabled = ")); Serial.println(noiseGate.getStatus());
+}
+
+
+
+// clipped samples at each point in the chain since the last report
+void printClipReport()
+{
+  Serial.println(F("Clipped samples since last report:"));
+  for (uint8_t i = 0; i < CLIP_INPUTS; i++)
+  {
+    Serial.print(F("  "));
+    Serial.print(clipNames[i]);
+    Serial.print(F(" = "));
+    Serial.println(clip1.readClips(i));
+  }
+  Serial.println();
+}
+
+
+
+// the dropouts logged since the last report, with the
+// effects on & what the main loop was doing
+void printDropoutReport()
+{
+  const char *types[] = {"late    ", "overrun ", "memory  "};
+  const char *units[] = {" us", " %", " blocks"};
+  DropoutEvent e;
+
+  Serial.println(F("Dropouts since last report (effects C E R D T F W c S G):"));
+  while (dropout1.readEvent(e))
+  {
+    Serial.print(F("  "));
+    Serial.print(e.ms);
+    Serial.print(F(" ms  "));
+    Serial.print(types[e.type]);
+    Serial.print(e.value);
+    Serial.print(units[e.type]);
+    Serial.print(F("  "));
+    printEffects(e.effects);
+    if (e.activity & ACT_SCREEN) Serial.print(F("  screen"));
+    if (e.activity & ACT_SD)     Serial.print(F("  sd"));
+    if (e.activity & ACT_EEPROM) Serial.print(F("  eeprom"));
+    Serial.println();
+  }
+
+  Serial.print(F("Total dropouts  = ")); Serial.println(dropout1.count());
+  Serial.print(F("Not logged      = ")); Serial.println(dropout1.countLost());
+  Serial.print(F("CPU max         = ")); Serial.println(AudioProcessorUsageMax());
+  AudioProcessorUsageMaxReset();
+  Serial.println();
 }
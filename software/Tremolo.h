@@ -231,7 +231,7 @@ void Tremolo :: process(bool initScreen)
 
 
   // allow some time for user to rotate encoders
-  delay(50);
+  idleDelay(50);
 
   // read encoders and check for changes
   checkEncoders();
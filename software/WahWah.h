@@ -36,6 +36,7 @@ class WahWah {
     void printConfig();
     void setValue(int);
     void update(int);
+    void setPosition(float pos, float ms);
     bool enabled;
 
   private:
@@ -135,3 +136,13 @@ void WahWah :: update(int pot)
 
   printValue("WahWah Settings Updated");
 }
+
+
+
+// pedal position 0 to 1.0, the filter sweeps there over ms
+// so it moves smoothly between pedal readings
+void WahWah :: setPosition(float pos, float ms)
+{
+  pos = constrain(pos, 0, 1.0);
+  dc2.amplitude(-1.0 + 2.0 * pos, ms);
+}
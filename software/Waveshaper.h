@@ -0,0 +1,332 @@
+/**********************************************************
+   Waveshaper Effect Class
+
+   Interface for the table lookup waveshaper (distortion).
+   Provides selection of the transfer curve, plus drive and
+   volume adjustments.
+
+   The curves are stored in flash as 257 entry tables (see
+   shapeCurves.h) and interpolated per sample by the
+   AudioEffectWaveshapeLUT node, so new drive characters
+   can be added by adding a table.
+
+   version 1.0   Oct 2026
+
+   adjustments:
+       curve: 0 = soft, 1 = hard, 2 = tube, 3 = fold
+       drive: 1.0 to 16.0 (0 to 24 dB into the curve)
+       volume: mixer input, float 0.0 to 1.0
+
+   Audio chain:
+   I2SIn -> Mixer1 -> Shape1 -> Mixer8_1 -> I2SOut
+
+ * **************************************************************/
+
+#ifndef WAVESHAPER_H
+#define WAVESHAPER_H
+
+
+#include "guiItems.h"
+#include "shapeCurves.h"
+
+extern Encoder paramEncoder;
+extern Encoder valueEncoder;
+
+
+class Waveshaper {
+  public:
+    Waveshaper();
+    void init();
+    void disable();
+    void enable();
+    void toggle();
+    bool getStatus();
+    void printConfig();
+    void process(bool);
+    void setValues(uint8_t c, float d, float v);
+    void update();
+    bool enabled;
+
+  private:
+    bool initialScreenDrawn;
+    bool selectedItemChanged;
+    bool itemValueChanged;
+    int8_t selectedItem;
+    int8_t lastselectedItem;
+
+    static const uint8_t numItems = 3;      // number of selectable items
+    static const uint8_t numSliders = 2;
+
+    // curve buttons
+    int16_t curveButtonsX = 40;
+    int16_t curveButtonsY = 40;
+    String curveLabels[NUM_SHAPE_CURVES];
+
+    // sliders
+    float sliderVal[numSliders];
+    int16_t sliderXPos[numSliders] = {165, 255};
+    int16_t sliderYPos = 2;
+
+    String labels[numItems] = {"Curve", "Drive", "Volume"};
+    int16_t labelXPos[numItems] = {20, 155, 240};
+
+    void convertToSlider();
+    void convertFromSlider();
+    bool checkEncoders();
+    void drawScreen(bool drawAll);
+};
+
+
+
+// this is run before audio board is initialized
+Waveshaper :: Waveshaper()
+{
+  initialScreenDrawn = false;
+  selectedItem = 0;
+  lastselectedItem = 0;
+  selectedItemChanged = false;
+
+  for (uint8_t i = 0; i < NUM_SHAPE_CURVES; i++)
+    curveLabels[i] = String(shapeCurveNames[i]);
+}
+
+
+
+// run after audio board is initialized
+void Waveshaper :: init()
+{
+  update();
+  disable();
+  printValue("Waveshaper initialized");
+}
+
+
+
+void Waveshaper :: disable()
+{
+  // set volume to 0 and stop the curve lookup
+  mixer8_1.gain(SHAPER_IN, 0);
+  shape1.shape(NULL);
+  enabled = false;
+  printValue("Waveshaper disabled");
+}
+
+
+
+void Waveshaper :: enable()
+{
+  shape1.shape(shapeCurves[cfg.shapeCurve]);
+  mixer8_1.gain(SHAPER_IN, cfg.shapeVolume);
+  enabled = true;
+  printValue("Waveshaper enabled");
+}
+
+
+void Waveshaper :: toggle()
+{
+  if (enabled)
+    disable();
+  else
+    enable();
+}
+
+
+
+bool Waveshaper :: getStatus()
+{
+  return enabled;
+}
+
+
+
+void Waveshaper :: setValues(uint8_t c, float d, float v)
+{
+  cfg.shapeCurve  = c;
+  cfg.shapeDrive  = d;
+  cfg.shapeVolume = v;
+  update();
+}
+
+
+
+// does the actual changes to the audio board
+void Waveshaper :: update()
+{
+  cfg.shapeCurve = constrain(cfg.shapeCurve, 0, NUM_SHAPE_CURVES - 1);
+  shape1.drive(cfg.shapeDrive);
+
+  if (enabled)
+    enable();
+  else
+    disable();
+
+  printValue("Waveshaper Settings Updated");
+}
+
+
+
+void Waveshaper :: printConfig()
+{
+  Serial.print(F("Shaper Enabled = "));   Serial.println(enabled);
+  Serial.print(F("Shaper Curve   = "));   Serial.println(shapeCurveNames[cfg.shapeCurve]);
+  Serial.print(F("Shaper Drive   = "));   Serial.println(cfg.shapeDrive);
+  Serial.print(F("Shaper Volume  = "));   Serial.println(cfg.shapeVolume);
+}
+
+
+
+// convert values to slider positions
+void Waveshaper :: convertToSlider()
+{
+  // drive is 1.0 to 16.0, volume 0 to 1.0
+  sliderVal[0] = (cfg.shapeDrive - 1.0) * (100.0 / 15.0);
+  sliderVal[1] = cfg.shapeVolume * 100.0;
+}
+
+
+
+// convert slider positions to values
+void Waveshaper :: convertFromSlider()
+{
+  cfg.shapeDrive  = sliderVal[0] * (15.0 / 100.0) + 1.0;
+  cfg.shapeVolume = sliderVal[1] / 100.0;
+
+  cfg.shapeDrive  = constrain(cfg.shapeDrive, 1.0, 16.0);
+  cfg.shapeVolume = constrain(cfg.shapeVolume, 0, 1.0);
+}
+
+
+
+// does the actual drawing to the LCD
+void Waveshaper :: drawScreen(bool drawAll)
+{
+  if (drawAll)
+  {
+    eraseScreen();
+
+    // draw separator
+    drawVLine(127, 0, 239, ILI9341_RED);
+
+    // add the labels
+    drawLabelsSelected(numItems, labelXPos, labels, selectedItem);
+
+    // add the title
+    drawTitle("Waveshaper");
+
+    // draw curve buttons
+    drawRadioButtons(curveButtonsX, curveButtonsY, NUM_SHAPE_CURVES, curveLabels, cfg.shapeCurve);
+
+    // draw sliders
+    for (uint8_t i = 0; i < numSliders; i++)
+      drawSlider(sliderXPos[i], sliderYPos, sliderVal[i], i + 1 == selectedItem);
+  }
+  else
+  {
+    // only draw selected item
+    if (selectedItem == 0)
+      drawRadioButtons(curveButtonsX, curveButtonsY, NUM_SHAPE_CURVES, curveLabels, cfg.shapeCurve);
+    else
+      drawSlider(sliderXPos[selectedItem - 1], sliderYPos, sliderVal[selectedItem - 1], true);
+  }
+}
+
+
+
+void Waveshaper :: process(bool initScreen)
+{
+  selectedItemChanged = false;
+  itemValueChanged = false;
+
+  // set the sliders values to the current stored settings
+  if (initScreen)
+    convertToSlider();
+
+  // allow some time for user to rotate encoders
+  idleDelay(50);
+
+  // read encoders and check for changes
+  checkEncoders();
+
+  if (selectedItemChanged || initScreen)
+  {
+    drawScreen(true);
+    printConfig();
+  }
+  else if (itemValueChanged)
+  {
+    convertFromSlider();
+    update();
+    drawScreen(false);
+  }
+
+  // reset encoder values for new delta
+  lastParamEncVal = paramEncVal;
+  lastValEncVal = valEncVal;
+}
+
+
+
+bool Waveshaper :: checkEncoders()
+{
+  // checks both param & value encoders for changes.
+  // Read the param encoder first, which selects the
+  // gui item. If changed, exits
+  // If no changes, the value encoder
+  // is read. Changes to value encoder increase or decrease
+  // the value of the "selected item"
+
+  paramEncVal = readParamEncoder() / 2;
+
+  if (paramEncVal != lastParamEncVal)
+  {
+    // save the current selected item
+    lastselectedItem = selectedItem;
+
+    // and then move to next or previous item, wraps-around
+    if (paramEncVal > lastParamEncVal)
+      selectedItem++;
+    else if (paramEncVal < lastParamEncVal)
+      selectedItem--;
+
+    if (selectedItem < 0)
+      selectedItem = numItems - 1;
+    selectedItem = selectedItem % numItems;
+
+    printValue("selectedItem", selectedItem);
+    selectedItemChanged = true;
+    return selectedItemChanged;
+  }
+  else
+  {
+    // if no param encoder changes, then read Value Encoder
+    valEncVal = readValueEncoder() / 2;
+    if (valEncVal != lastValEncVal)
+    {
+      if (selectedItem == 0)
+      {
+        // curve buttons
+        if (valEncVal > lastValEncVal && cfg.shapeCurve < NUM_SHAPE_CURVES - 1)
+          cfg.shapeCurve += 1;
+        else if (valEncVal < lastValEncVal && cfg.shapeCurve > 0)
+          cfg.shapeCurve -= 1;
+      }
+      else
+      {
+        // increase or decrease the slider's new position (need to re-draw later)
+        if (valEncVal > lastValEncVal)
+          sliderVal[selectedItem - 1] += 4;
+        else if (valEncVal < lastValEncVal)
+          sliderVal[selectedItem - 1] -= 4;
+
+        // keep it in the slider's range
+        sliderVal[selectedItem - 1] = constrain(sliderVal[selectedItem - 1], 0, 100.0);
+      }
+
+      itemValueChanged = true;
+      return itemValueChanged;
+    }
+    return false;
+  }
+}
+
+#endif
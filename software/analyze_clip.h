@@ -0,0 +1,106 @@
+/**************************************************************
+    analyze_clip.h - clip counter for several points in the chain
+
+    version 1.0   Oct 2026
+
+    Audio library analyzer with CLIP_INPUTS inputs, each
+    connected to the output of a node that could clip (mostly
+    mixers summing several effects at full gain). It counts the
+    samples that hit full scale (+32767 or -32767/-32768) on
+    each input, since the library nodes saturate there when
+    they overload.
+
+    The library nodes can't be changed, so one tap node does
+    the counting for all of them. Each block costs 1 compare
+    per sample per input, missing (silent) blocks cost nothing.
+
+    readClips(n) returns the count for input n since the last
+    read, clipMask() has a bit set for each input that clipped
+    since it was last called.
+
+ **************************************************************/
+
+#ifndef ANALYZE_CLIP_H
+#define ANALYZE_CLIP_H
+
+#include <AudioStream.h>
+
+
+#define CLIP_INPUTS   7
+
+// samples at or beyond this are counted
+#define CLIP_LEVEL    32767
+
+
+
+class AudioAnalyzeClip : public AudioStream
+{
+  public:
+    AudioAnalyzeClip() : AudioStream(CLIP_INPUTS, inputQueueArray)
+    {
+      mask = 0;
+      for (uint8_t i = 0; i < CLIP_INPUTS; i++)
+        clips[i] = 0;
+    }
+
+    // clipped samples on this input since the last read
+    uint32_t readClips(uint8_t input)
+    {
+      if (input >= CLIP_INPUTS)
+        return 0;
+
+      __disable_irq();
+      uint32_t n = clips[input];
+      clips[input] = 0;
+      __enable_irq();
+      return n;
+    }
+
+    // bit n set if input n clipped since the last call
+    uint8_t clipMask()
+    {
+      __disable_irq();
+      uint8_t m = mask;
+      mask = 0;
+      __enable_irq();
+      return m;
+    }
+
+    virtual void update(void);
+
+  private:
+    audio_block_t *inputQueueArray[CLIP_INPUTS];
+    volatile uint32_t clips[CLIP_INPUTS];
+    volatile uint8_t mask;
+};
+
+
+
+void AudioAnalyzeClip :: update(void)
+{
+  audio_block_t *block;
+
+  for (uint8_t n = 0; n < CLIP_INPUTS; n++)
+  {
+    block = receiveReadOnly(n);
+    if (!block)
+      continue;
+
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+    {
+      int16_t s = block->data[i];
+      if (s >= CLIP_LEVEL || s <= -CLIP_LEVEL)
+        count++;
+    }
+    release(block);
+
+    if (count)
+    {
+      clips[n] += count;
+      mask |= 1 << n;
+    }
+  }
+}
+
+#endif
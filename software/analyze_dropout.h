@@ -0,0 +1,210 @@
+/**************************************************************
+    analyze_dropout.h - logs audio updates that were late
+
+    version 1.0   Oct 2026
+
+    Audio library node with no outputs. It's created before
+    all the others (patches.h) so it runs first in every
+    audio update, and times the updates with the cycle
+    counter. The input is only there because the library
+    doesn't update nodes without a connection, the blocks
+    are thrown away.
+
+    DROPOUT_LATE     the update started more than 1.5 blocks
+                     after the last one, interrupts were held
+                     off (SPI, AudioNoInterrupts...) and the
+                     I2S DMA played a block twice
+    DROPOUT_OVERRUN  the last update took longer than a block
+                     to run
+    DROPOUT_MEMORY   the audio memory pool ran out, nodes get
+                     no blocks & send silence. Logged once
+                     each time it fills up.
+
+    Each event is kept in a ring buffer with the millis()
+    time, the effects that were on and what the main loop
+    was doing. The main loop sets those with setEffects()
+    and activityStart() / activityEnd(). Activities are
+    sticky until the next update, so one that disabled
+    interrupts is still tagged when the late update runs.
+    ACT_SCREEN is paused while a screen waits in idleDelay(),
+    so only drawing is tagged.
+    When the buffer is full the oldest events are dropped.
+
+ **************************************************************/
+
+#ifndef ANALYZE_DROPOUT_H
+#define ANALYZE_DROPOUT_H
+
+#include <AudioStream.h>
+
+
+#define DROPOUT_LOG_SIZE  32
+
+// event types
+#define DROPOUT_LATE      0
+#define DROPOUT_OVERRUN   1
+#define DROPOUT_MEMORY    2
+
+// main loop activities
+#define ACT_SCREEN        0x01    // lcd drawing
+#define ACT_SD            0x02    // sd card reads & writes
+#define ACT_EEPROM        0x04    // config & presets
+
+
+struct DropoutEvent
+{
+  uint32_t ms;
+  uint16_t effects;
+  uint8_t  type;
+  uint8_t  activity;
+  uint16_t value;     // late: gap in us, overrun: cpu %, memory: blocks
+};
+
+
+
+class AudioAnalyzeDropout : public AudioStream
+{
+  public:
+    AudioAnalyzeDropout(uint16_t poolBlocks) : AudioStream(1, inputQueueArray)
+    {
+      pool = poolBlocks;
+      lastCycles = 0;
+      started = false;
+      memFull = false;
+      head = 0;
+      tail = 0;
+      total = 0;
+      lost = 0;
+      effects = 0;
+      activity = 0;
+      seen = 0;
+    }
+
+    void setEffects(uint16_t mask)
+    {
+      effects = mask;
+    }
+
+    void activityStart(uint8_t bits)
+    {
+      __disable_irq();
+      activity |= bits;
+      seen |= bits;
+      __enable_irq();
+    }
+
+    void activityEnd(uint8_t bits)
+    {
+      __disable_irq();
+      activity &= ~bits;
+      __enable_irq();
+    }
+
+    // the ones started & not ended
+    uint8_t activities()
+    {
+      return activity;
+    }
+
+    // oldest event, false if there are none
+    bool readEvent(DropoutEvent &e)
+    {
+      __disable_irq();
+      bool ok = head != tail;
+      if (ok)
+      {
+        e = log[tail];
+        tail = (tail + 1) % DROPOUT_LOG_SIZE;
+      }
+      __enable_irq();
+      return ok;
+    }
+
+    // since startup
+    uint32_t count()
+    {
+      return total;
+    }
+
+    // pushed out of a full log
+    uint32_t countLost()
+    {
+      return lost;
+    }
+
+    virtual void update(void);
+
+  private:
+    audio_block_t *inputQueueArray[1];
+    uint16_t pool;
+    uint32_t lastCycles;
+    bool started;
+    bool memFull;
+
+    DropoutEvent log[DROPOUT_LOG_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile uint32_t total;
+    volatile uint32_t lost;
+
+    volatile uint16_t effects;
+    volatile uint8_t activity;
+    volatile uint8_t seen;
+
+    void addEvent(uint8_t type, uint32_t value);
+};
+
+
+
+// in the audio interrupt
+void AudioAnalyzeDropout :: addEvent(uint8_t type, uint32_t value)
+{
+  DropoutEvent &e = log[head];
+  e.ms = millis();
+  e.effects = effects;
+  e.type = type;
+  e.activity = activity | seen;
+  e.value = min(value, (uint32_t)0xffff);
+
+  head = (head + 1) % DROPOUT_LOG_SIZE;
+  if (head == tail)
+  {
+    tail = (tail + 1) % DROPOUT_LOG_SIZE;
+    lost++;
+  }
+  total++;
+}
+
+
+
+void AudioAnalyzeDropout :: update(void)
+{
+  const uint32_t blockCycles = (uint32_t)(F_CPU / AUDIO_SAMPLE_RATE_EXACT * AUDIO_BLOCK_SAMPLES);
+  uint32_t now = ARM_DWT_CYCCNT;
+  uint32_t gap = now - lastCycles;
+  lastCycles = now;
+
+  audio_block_t *block = receiveReadOnly();
+  if (block)
+    release(block);
+
+  if (started)
+  {
+    // processor usage is for the whole of the last update
+    if (gap > blockCycles + blockCycles / 2)
+      addEvent(DROPOUT_LATE, gap / (F_CPU / 1000000));
+    else if (AudioProcessorUsage() > 100)
+      addEvent(DROPOUT_OVERRUN, AudioProcessorUsage());
+  }
+  started = true;
+
+  // each time the pool fills up
+  uint16_t used = AudioMemoryUsage();
+  if (used >= pool && !memFull)
+    addEvent(DROPOUT_MEMORY, used);
+  memFull = used >= pool;
+
+  seen = activity;
+}
+
+#endif
@@ -0,0 +1,262 @@
+/**************************************************************
+    analyze_loudness.h - RMS and short-term loudness node
+
+    version 1.0   Oct 2026
+
+    Audio library analyzer giving the RMS level and a short-term
+    loudness estimate, in the style of EBU R128 / BS.1770, so
+    levels can be matched by how loud they sound instead of
+    by their peaks.
+
+    RMS:  sum of squares of every block, using the packed
+          SMLALD instruction (2 multiply-accumulates per cycle
+          into a 64 bit sum), averaged over the blocks since
+          the last read.
+
+    LUFS: the block is K-weighted (high shelf +4 dB above
+          1.5 kHz, then a 38 Hz high pass), summed the same way,
+          and the mean square over the last 3 seconds is
+          converted with  -0.691 + 10 * log10(mean square).
+          The window is 30 segments of 100 ms, so a new value
+          is ready 10 times a second.
+
+    The K-weighting filters are 1 biquad each in floating
+    point, with the output halved so the shelf can't clip.
+
+ **************************************************************/
+
+#ifndef ANALYZE_LOUDNESS_H
+#define ANALYZE_LOUDNESS_H
+
+#include <AudioStream.h>
+
+
+// blocks per 100 ms segment, 30 segments = 3 sec short-term window
+#define LOUDNESS_SEGMENT_BLOCKS  34
+#define LOUDNESS_SEGMENTS        30
+
+// rms average restarts if not read for this many blocks (~3 min)
+#define LOUDNESS_RMS_MAX_BLOCKS  65536
+
+// level reported for silence
+#define LOUDNESS_FLOOR           -96.0
+
+
+
+// sum of squares of a block, 2 samples at a time
+static inline uint64_t sumOfSquares(const int16_t *data)
+{
+  const uint32_t *p = (const uint32_t *)data;
+  uint64_t sum = 0;
+
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES / 2; i++)
+  {
+#if defined(KINETISK)
+    uint32_t pair = *p++;
+    asm volatile("smlald %Q0, %R0, %1, %1" : "+r" (sum) : "r" (pair));
+#else
+    int32_t a = data[2 * i];
+    int32_t b = data[2 * i + 1];
+    sum += a * a + b * b;
+#endif
+  }
+  return sum;
+}
+
+
+
+class AudioAnalyzeLoudness : public AudioStream
+{
+  public:
+    AudioAnalyzeLoudness() : AudioStream(1, inputQueueArray)
+    {
+      rmsSum = 0;
+      rmsBlocks = 0;
+      segmentSum = 0;
+      segmentBlocks = 0;
+      segment = 0;
+      windowSum = 0;
+      newLoudness = false;
+      for (uint8_t i = 0; i < LOUDNESS_SEGMENTS; i++)
+        segments[i] = 0;
+      for (uint8_t i = 0; i < 4; i++)
+        shelfState[i] = highPassState[i] = 0;
+      calcKWeighting();
+    }
+
+    // RMS since the last read, in dBFS
+    float readRMS()
+    {
+      __disable_irq();
+      uint64_t sum = rmsSum;
+      uint32_t blocks = rmsBlocks;
+      rmsSum = 0;
+      rmsBlocks = 0;
+      __enable_irq();
+
+      if (blocks == 0 || sum == 0)
+        return LOUDNESS_FLOOR;
+      float meanSquare = (float)sum / ((float)blocks * AUDIO_BLOCK_SAMPLES * 32768.0 * 32768.0);
+      return max(10.0 * log10f(meanSquare), LOUDNESS_FLOOR);
+    }
+
+    // true when a new short-term value is ready
+    bool available()
+    {
+      return newLoudness;
+    }
+
+    // short-term (3 sec) loudness, in LUFS
+    float readLoudness()
+    {
+      newLoudness = false;
+      return peekLoudness();
+    }
+
+    // same as readLoudness(), but leaves available() set,
+    // for a reader besides the one that waits on it
+    float peekLoudness()
+    {
+      __disable_irq();
+      uint64_t sum = windowSum;
+      __enable_irq();
+
+      if (sum == 0)
+        return LOUDNESS_FLOOR;
+
+      // K-weighted samples were halved, so 4x the mean square
+      float meanSquare = 4.0 * (float)sum /
+                         ((float)LOUDNESS_SEGMENTS * LOUDNESS_SEGMENT_BLOCKS * AUDIO_BLOCK_SAMPLES * 32768.0 * 32768.0);
+      return max(-0.691 + 10.0 * log10f(meanSquare), LOUDNESS_FLOOR);
+    }
+
+    virtual void update(void);
+
+  private:
+    void calcKWeighting();
+    void biquad(const float *c, float *z, float *data);
+
+    audio_block_t *inputQueueArray[1];
+
+    // rms
+    volatile uint64_t rmsSum;
+    volatile uint32_t rmsBlocks;
+
+    // loudness
+    uint64_t segmentSum;
+    uint16_t segmentBlocks;
+    uint64_t segments[LOUDNESS_SEGMENTS];
+    uint8_t segment;
+    volatile uint64_t windowSum;
+    volatile bool newLoudness;
+
+    // K-weighting, {b0, b1, b2, a1, a2} & DF1 state
+    float shelfCoefs[5];
+    float highPassCoefs[5];
+    float shelfState[4];
+    float highPassState[4];
+};
+
+
+
+// BS.1770 K-weighting filters, recalculated for the audio
+// library's sample rate
+void AudioAnalyzeLoudness :: calcKWeighting()
+{
+  float fs = AUDIO_SAMPLE_RATE_EXACT;
+
+  // stage 1, high shelf
+  float K = tanf(PI * 1681.974450955533 / fs);
+  float Vh = powf(10.0, 3.999843853973347 / 20.0);
+  float Vb = powf(Vh, 0.4996667741545416);
+  float Q = 0.7071752369554196;
+  float a0 = 1.0 + K / Q + K * K;
+
+  shelfCoefs[0] = (Vh + Vb * K / Q + K * K) / a0;
+  shelfCoefs[1] = 2.0 * (K * K - Vh) / a0;
+  shelfCoefs[2] = (Vh - Vb * K / Q + K * K) / a0;
+  shelfCoefs[3] = 2.0 * (K * K - 1.0) / a0;
+  shelfCoefs[4] = (1.0 - K / Q + K * K) / a0;
+
+  // stage 2, high pass
+  K = tanf(PI * 38.13547087602444 / fs);
+  Q = 0.5003270373238773;
+  a0 = 1.0 + K / Q + K * K;
+
+  highPassCoefs[0] = 1.0;
+  highPassCoefs[1] = -2.0;
+  highPassCoefs[2] = 1.0;
+  highPassCoefs[3] = 2.0 * (K * K - 1.0) / a0;
+  highPassCoefs[4] = (1.0 - K / Q + K * K) / a0;
+}
+
+
+
+// direct form I, z = {x1, x2, y1, y2}
+void AudioAnalyzeLoudness :: biquad(const float *c, float *z, float *data)
+{
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+  {
+    float x = data[i];
+    float y = c[0] * x + c[1] * z[0] + c[2] * z[1] - c[3] * z[2] - c[4] * z[3];
+    z[1] = z[0];
+    z[0] = x;
+    z[3] = z[2];
+    z[2] = y;
+    data[i] = y;
+  }
+}
+
+
+
+void AudioAnalyzeLoudness :: update(void)
+{
+  audio_block_t *block;
+  float weighted[AUDIO_BLOCK_SAMPLES];
+  int16_t kData[AUDIO_BLOCK_SAMPLES] __attribute__ ((aligned (4)));
+  uint64_t kSum = 0;
+
+  if (rmsBlocks >= LOUDNESS_RMS_MAX_BLOCKS)
+  {
+    rmsSum = 0;
+    rmsBlocks = 0;
+  }
+
+  // a missing block is silence, it still counts towards the window
+  block = receiveReadOnly();
+  if (block)
+  {
+    rmsSum += sumOfSquares(block->data);
+
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+      weighted[i] = block->data[i] * 0.5;
+    release(block);
+
+    biquad(shelfCoefs, shelfState, weighted);
+    biquad(highPassCoefs, highPassState, weighted);
+
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+    {
+      float y = constrain(weighted[i], -32768.0, 32767.0);
+      kData[i] = (int16_t)y;
+    }
+    kSum = sumOfSquares(kData);
+  }
+  rmsBlocks++;
+
+  // 100 ms segments into the 3 sec sliding window
+  segmentSum += kSum;
+  if (++segmentBlocks < LOUDNESS_SEGMENT_BLOCKS)
+    return;
+
+  uint64_t sum = windowSum - segments[segment] + segmentSum;
+  segments[segment] = segmentSum;
+  segment = (segment + 1) % LOUDNESS_SEGMENTS;
+  segmentSum = 0;
+  segmentBlocks = 0;
+
+  windowSum = sum;
+  newLoudness = true;
+}
+
+#endif
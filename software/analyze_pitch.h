@@ -0,0 +1,435 @@
+/**************************************************************
+    analyze_pitch.h - pitch detector for the guitar tuner
+
+    version 1.0   Oct 2026
+
+    Audio library analyzer that replaces AudioAnalyzeNoteFrequency
+    for the tuner. Guitar fundamentals are all below ~1.3 kHz, so
+    the input is low pass filtered and decimated by 8 (5.5 kHz)
+    before running the YIN pitch detector on it. That makes the
+    YIN buffer 8 times shorter and the difference function 64
+    times cheaper, so it can run on every 64 new samples (11.6 ms)
+    instead of once per 1024+ samples.
+
+      buffer:  128 sample window + 96 lags = 224 samples, 41 ms
+      range:   57 Hz (lag 96) to 1378 Hz (lag 4)
+
+    The difference function uses the packed QSUB16 & SMLALD
+    instructions, 2 samples per step, samples are stored at
+    half scale so the differences can't saturate.
+
+    YIN: de Cheveigne & Kawahara, "YIN, a fundamental frequency
+    estimator for speech and music", JASA 2002.
+
+    For the strobe tuner, setTarget() gives a note frequency to
+    measure the phase against. Each hop the buffer is Hann
+    windowed and correlated with a reference oscillator at the
+    target, so the phase is steady when in tune and turns at
+    the frequency error when not. The change in phase between
+    hops, averaged, gives the error to a fraction of a cent.
+
+    Nothing is done unless enabled, so it costs nothing when
+    the tuner isn't running.
+
+ **************************************************************/
+
+#ifndef ANALYZE_PITCH_H
+#define ANALYZE_PITCH_H
+
+#include <AudioStream.h>
+
+
+#define PITCH_DECIMATE      8
+#define PITCH_SAMPLE_RATE   (AUDIO_SAMPLE_RATE_EXACT / PITCH_DECIMATE)
+
+#define PITCH_WINDOW        128
+#define PITCH_MAX_LAG       96
+#define PITCH_MIN_LAG       4
+#define PITCH_BUFFER        (PITCH_WINDOW + PITCH_MAX_LAG)
+#define PITCH_HOP           64
+
+// YIN threshold on the normalized difference function
+#define PITCH_THRESHOLD     0.15
+
+// quietest peak (half scale samples) that will be analyzed
+#define PITCH_MIN_LEVEL     100
+
+// decimation low pass, 4th order Butterworth
+#define PITCH_LPF_FREQ      1200.0
+
+
+
+// YIN difference function at one lag, 2 samples per step
+static inline uint64_t yinDifference(const int16_t *x, uint16_t tau)
+{
+  uint64_t sum = 0;
+
+  for (uint16_t j = 0; j < PITCH_WINDOW; j += 2)
+  {
+#if defined(KINETISK)
+    uint32_t a, b, d;
+    memcpy(&a, &x[j], 4);
+    memcpy(&b, &x[j + tau], 4);
+    asm("qsub16 %0, %1, %2" : "=r" (d) : "r" (a), "r" (b));
+    asm("smlald %Q0, %R0, %1, %1" : "+r" (sum) : "r" (d));
+#else
+    int32_t d0 = x[j] - x[j + tau];
+    int32_t d1 = x[j + 1] - x[j + 1 + tau];
+    sum += d0 * d0 + d1 * d1;
+#endif
+  }
+  return sum;
+}
+
+
+
+// low pass & decimate by PITCH_DECIMATE, output at half scale.
+// Shared by the pitch & strum analyzers
+class PitchDecimator
+{
+  public:
+    void init();
+    void reset();
+
+    // filter a sample, true when a decimated one is ready
+    inline bool process(int16_t in, int16_t *out)
+    {
+      float y = in * 0.5;
+
+      for (uint8_t s = 0; s < 2; s++)
+      {
+        float *c = coefs[s];
+        float *z = state[s];
+        float x = y;
+        y = c[0] * x + c[1] * z[0] + c[2] * z[1] - c[3] * z[2] - c[4] * z[3];
+        z[1] = z[0];
+        z[0] = x;
+        z[3] = z[2];
+        z[2] = y;
+      }
+
+      if (++phase < PITCH_DECIMATE)
+        return false;
+      phase = 0;
+
+      *out = (int16_t)constrain(y, -16384.0, 16383.0);
+      return true;
+    }
+
+  private:
+    // 2 biquads {b0, b1, b2, a1, a2} & DF1 state
+    float coefs[2][5];
+    float state[2][4];
+    uint8_t phase;
+};
+
+
+
+// RBJ low pass biquads with the Q's of a 4th order Butterworth
+void PitchDecimator :: init()
+{
+  const float q[2] = {0.5412, 1.3066};
+  float w0 = 2.0 * PI * PITCH_LPF_FREQ / AUDIO_SAMPLE_RATE_EXACT;
+  float cosw = cosf(w0);
+
+  for (uint8_t s = 0; s < 2; s++)
+  {
+    float alpha = sinf(w0) / (2.0 * q[s]);
+    float a0 = 1.0 + alpha;
+    coefs[s][0] = (1.0 - cosw) / 2.0 / a0;
+    coefs[s][1] = (1.0 - cosw) / a0;
+    coefs[s][2] = (1.0 - cosw) / 2.0 / a0;
+    coefs[s][3] = -2.0 * cosw / a0;
+    coefs[s][4] = (1.0 - alpha) / a0;
+  }
+  reset();
+}
+
+
+
+void PitchDecimator :: reset()
+{
+  for (uint8_t s = 0; s < 2; s++)
+    for (uint8_t i = 0; i < 4; i++)
+      state[s][i] = 0;
+  phase = 0;
+}
+
+
+
+class AudioAnalyzePitch : public AudioStream
+{
+  public:
+    AudioAnalyzePitch() : AudioStream(1, inputQueueArray)
+    {
+      enabled = false;
+      newPitch = false;
+      frequency = 0;
+      prob = 0;
+      targetOmega = 0;
+      refPhase = 0;
+      targetPhase = 0;
+      havePhase = false;
+      offsetSum = 0;
+      offsetCount = 0;
+      for (uint16_t i = 0; i < PITCH_BUFFER; i++)
+        window[i] = 0.5 - 0.5 * cosf(2.0 * PI * i / PITCH_BUFFER);
+      decimator.init();
+      reset();
+    }
+
+    // start or stop the detector
+    void enable(bool state)
+    {
+      __disable_irq();
+      if (state && !enabled)
+        reset();
+      enabled = state;
+      __enable_irq();
+    }
+
+    // true when a new estimate is ready
+    bool available()
+    {
+      return newPitch;
+    }
+
+    // fundamental in Hz
+    float read()
+    {
+      __disable_irq();
+      float f = frequency;
+      newPitch = false;
+      __enable_irq();
+      return f;
+    }
+
+    // confidence of the last estimate, 0 to 1.0
+    float probability()
+    {
+      return prob;
+    }
+
+    // frequency to measure the phase against, 0 = off
+    void setTarget(float freq)
+    {
+      __disable_irq();
+      targetOmega = 2.0 * PI * freq / PITCH_SAMPLE_RATE;
+      havePhase = false;
+      offsetSum = 0;
+      offsetCount = 0;
+      __enable_irq();
+    }
+
+    // phase relative to the target, -PI to PI
+    float readPhase()
+    {
+      return targetPhase;
+    }
+
+    // true when there are phase changes to average
+    bool offsetAvailable()
+    {
+      return offsetCount > 0;
+    }
+
+    // average frequency error from the target in Hz, since the
+    // last read
+    float readOffset()
+    {
+      __disable_irq();
+      float sum = offsetSum;
+      uint16_t count = offsetCount;
+      offsetSum = 0;
+      offsetCount = 0;
+      __enable_irq();
+
+      if (count == 0)
+        return 0;
+      return sum / count * PITCH_SAMPLE_RATE / (2.0 * PI * PITCH_HOP);
+    }
+
+    virtual void update(void);
+
+  private:
+    void reset();
+    void decimate(const int16_t *data);
+    void findPitch();
+    void findPhase();
+
+    audio_block_t *inputQueueArray[1];
+    volatile bool enabled;
+    volatile bool newPitch;
+    volatile float frequency;
+    volatile float prob;
+
+    PitchDecimator decimator;
+    int16_t buffer[PITCH_BUFFER] __attribute__ ((aligned (4)));
+    uint16_t fill;
+
+    // phase against the target
+    float window[PITCH_BUFFER];
+    volatile float targetOmega;
+    float refPhase;
+    volatile float targetPhase;
+    bool havePhase;
+    volatile float offsetSum;
+    volatile uint16_t offsetCount;
+};
+
+
+
+void AudioAnalyzePitch :: reset()
+{
+  decimator.reset();
+  fill = 0;
+  havePhase = false;
+}
+
+
+
+// filter the block and keep every 8th sample. A missing
+// block is silence
+void AudioAnalyzePitch :: decimate(const int16_t *data)
+{
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+  {
+    if (!decimator.process(data ? data[i] : 0, &buffer[fill]))
+      continue;
+
+    if (++fill == PITCH_BUFFER)
+    {
+      findPitch();
+
+      // slide the buffer along by one hop, the reference
+      // oscillator moves with it
+      memmove(buffer, &buffer[PITCH_HOP], (PITCH_BUFFER - PITCH_HOP) * sizeof(int16_t));
+      fill = PITCH_BUFFER - PITCH_HOP;
+      refPhase = fmodf(refPhase + targetOmega * PITCH_HOP, 2.0 * PI);
+    }
+  }
+}
+
+
+
+void AudioAnalyzePitch :: findPitch()
+{
+  float diff[PITCH_MAX_LAG + 1];
+  float cmndf[PITCH_MAX_LAG + 1];
+  uint64_t runningSum = 0;
+  int16_t peak = 0;
+
+  for (uint16_t i = 0; i < PITCH_BUFFER; i++)
+  {
+    if (abs(buffer[i]) > peak)
+      peak = abs(buffer[i]);
+  }
+  if (peak < PITCH_MIN_LEVEL)
+  {
+    havePhase = false;
+    return;
+  }
+
+  findPhase();
+
+  // cumulative mean normalized difference function
+  diff[0] = 0;
+  cmndf[0] = 1.0;
+  for (uint16_t tau = 1; tau <= PITCH_MAX_LAG; tau++)
+  {
+    uint64_t d = yinDifference(buffer, tau);
+    runningSum += d;
+    diff[tau] = d;
+    cmndf[tau] = runningSum ? (float)d * tau / (float)runningSum : 1.0;
+  }
+
+  // first dip below the threshold, then down to its minimum
+  uint16_t tau = PITCH_MIN_LAG;
+  while (tau < PITCH_MAX_LAG && cmndf[tau] >= PITCH_THRESHOLD)
+    tau++;
+  if (tau == PITCH_MAX_LAG)
+    return;
+  while (tau < PITCH_MAX_LAG && cmndf[tau + 1] < cmndf[tau])
+    tau++;
+
+  // parabolic interpolation of the difference function between lags
+  float better = tau;
+  if (tau > 1 && tau < PITCH_MAX_LAG)
+  {
+    float s0 = diff[tau - 1];
+    float s1 = diff[tau];
+    float s2 = diff[tau + 1];
+    float denom = s0 - 2.0 * s1 + s2;
+    if (denom != 0)
+      better += 0.5 * (s0 - s2) / denom;
+  }
+
+  frequency = PITCH_SAMPLE_RATE / better;
+  prob = 1.0 - cmndf[tau];
+  newPitch = true;
+}
+
+
+
+// windowed buffer correlated with the reference oscillator,
+// which is at refPhase for buffer[0]
+void AudioAnalyzePitch :: findPhase()
+{
+  if (targetOmega == 0)
+    return;
+
+  float c = cosf(targetOmega);
+  float s = sinf(targetOmega);
+  float refCos = cosf(refPhase);
+  float refSin = sinf(refPhase);
+  float re = 0;
+  float im = 0;
+
+  for (uint16_t i = 0; i < PITCH_BUFFER; i++)
+  {
+    float x = buffer[i] * window[i];
+    re += x * refCos;
+    im -= x * refSin;
+
+    float t = refCos * c - refSin * s;
+    refSin = refSin * c + refCos * s;
+    refCos = t;
+  }
+
+  float p = atan2f(im, re);
+
+  // phase change since the last hop, wrapped to +-PI
+  if (havePhase)
+  {
+    float d = p - targetPhase;
+    if (d > PI)
+      d -= 2.0 * PI;
+    else if (d < -PI)
+      d += 2.0 * PI;
+    offsetSum += d;
+    offsetCount++;
+  }
+  targetPhase = p;
+  havePhase = true;
+}
+
+
+
+void AudioAnalyzePitch :: update(void)
+{
+  audio_block_t *block;
+
+  block = receiveReadOnly();
+  if (!enabled)
+  {
+    if (block)
+      release(block);
+    return;
+  }
+
+  decimate(block ? block->data : NULL);
+  if (block)
+    release(block);
+}
+
+#endif
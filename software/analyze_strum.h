@@ -0,0 +1,101 @@
+/**************************************************************
+    analyze_strum.h - capture for the polyphonic (strum) tuner
+
+    version 1.0   Oct 2026
+
+    Audio library node that keeps the last STRUM_SAMPLES of the
+    input, low pass filtered and decimated by 8 the same way
+    as the pitch analyzer (5.5 kHz, 0.74 sec of audio). The
+    audio interrupt only filters and stores the samples, the
+    FFT of all six strings is done from the main loop (see
+    strum.h), which reads a copy of the buffer.
+
+    Nothing is done unless enabled.
+
+ **************************************************************/
+
+#ifndef ANALYZE_STRUM_H
+#define ANALYZE_STRUM_H
+
+#include <AudioStream.h>
+#include "analyze_pitch.h"
+
+
+#define STRUM_SAMPLES   4096
+
+
+
+class AudioAnalyzeStrum : public AudioStream
+{
+  public:
+    AudioAnalyzeStrum() : AudioStream(1, inputQueueArray)
+    {
+      enabled = false;
+      head = 0;
+      decimator.init();
+      memset(buffer, 0, sizeof(buffer));
+    }
+
+    // start or stop the capture
+    void enable(bool state)
+    {
+      __disable_irq();
+      if (state && !enabled)
+      {
+        decimator.reset();
+        memset(buffer, 0, sizeof(buffer));
+        head = 0;
+      }
+      enabled = state;
+      __enable_irq();
+    }
+
+    // copy of the last STRUM_SAMPLES, oldest first
+    void read(int16_t *dest)
+    {
+      __disable_irq();
+      uint16_t h = head;
+      memcpy(dest, &buffer[h], (STRUM_SAMPLES - h) * sizeof(int16_t));
+      memcpy(&dest[STRUM_SAMPLES - h], buffer, h * sizeof(int16_t));
+      __enable_irq();
+    }
+
+    virtual void update(void);
+
+  private:
+    audio_block_t *inputQueueArray[1];
+    volatile bool enabled;
+
+    PitchDecimator decimator;
+    int16_t buffer[STRUM_SAMPLES];
+    volatile uint16_t head;
+};
+
+
+
+// a missing block is silence
+void AudioAnalyzeStrum :: update(void)
+{
+  audio_block_t *block;
+
+  block = receiveReadOnly();
+  if (!enabled)
+  {
+    if (block)
+      release(block);
+    return;
+  }
+
+  uint16_t h = head;
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+  {
+    if (decimator.process(block ? block->data[i] : 0, &buffer[h]))
+      h = (h + 1) % STRUM_SAMPLES;
+  }
+  head = h;
+
+  if (block)
+    release(block);
+}
+
+#endif
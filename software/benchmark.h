@@ -0,0 +1,206 @@
+/**************************************
+   benchmark.h - on-target timing of the
+   per-sample audio code
+
+   version 1.0   Oct 2026
+
+   Uses the Cortex-M4 cycle counter to time the
+   inner loops of the custom audio nodes on a
+   test block, outside the audio interrupt.
+   Run from the serial port with 'b'.
+
+   The parametric EQ is timed with 1 to 8 stages so
+   the cost per stage can be read off the results.
+
+   measureIdleCpu() compares the cpu used with no
+   guitar playing, with and without silent blocks
+   being skipped. Run with 'i'.
+
+ ***************************************/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+
+// number of blocks timed per test
+#define BENCH_BLOCKS  1000
+
+// idle cpu measurement, number of readings & time between them
+#define IDLE_READINGS   100
+#define IDLE_READ_MS    10
+
+
+// prototypes
+void startCycleCounter();
+void printBenchResult(const char*, uint32_t);
+void benchWaveshaper();
+void benchParametricEQ();
+void runBenchmarks();
+void readIdleCpu(const char*);
+void measureIdleCpu();
+
+
+
+void startCycleCounter()
+{
+  ARM_DEMCR |= ARM_DEMCR_TRCENA;
+  ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+}
+
+
+
+// cycles is the total for BENCH_BLOCKS blocks
+void printBenchResult(const char* name, uint32_t cycles)
+{
+  float perBlock  = (float)cycles / BENCH_BLOCKS;
+  float perSample = perBlock / AUDIO_BLOCK_SAMPLES;
+
+  // percent of the time available between audio interrupts
+  float load = perBlock * 100.0 / ((float)F_CPU * AUDIO_BLOCK_SAMPLES / AUDIO_SAMPLE_RATE_EXACT);
+
+  Serial.print(name);
+  Serial.print(F(": "));
+  Serial.print(perBlock, 0);
+  Serial.print(F(" cycles/block, "));
+  Serial.print(perSample, 2);
+  Serial.print(F(" cycles/sample, "));
+  Serial.print(load, 2);
+  Serial.println(F("% cpu"));
+}
+
+
+
+void benchWaveshaper()
+{
+  int16_t data[AUDIO_BLOCK_SAMPLES];
+  uint32_t cycles = 0;
+
+  for (uint8_t c = 0; c < NUM_SHAPE_CURVES; c++)
+  {
+    cycles = 0;
+    for (uint16_t n = 0; n < BENCH_BLOCKS; n++)
+    {
+      // full scale ramp so every part of the table is read
+      for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+        data[i] = (int16_t)(i * 512 - 32768 + n);
+
+      uint32_t start = ARM_DWT_CYCCNT;
+      waveshapeBlock(data, shapeCurves[c], 4 * 256);
+      cycles += ARM_DWT_CYCCNT - start;
+    }
+    Serial.print(F("Waveshaper "));
+    printBenchResult(shapeCurveNames[c], cycles);
+  }
+}
+
+
+
+void benchParametricEQ()
+{
+  arm_biquad_casd_df1_inst_q31 cascade;
+  int32_t coefs[PEQ_MAX_STAGES * 5];
+  int32_t state[PEQ_MAX_STAGES * 4];
+  int32_t data[AUDIO_BLOCK_SAMPLES];
+  uint32_t cycles;
+
+  // a typical boost on every band
+  for (uint8_t s = 0; s < PEQ_MAX_STAGES; s++)
+    peqCoefficients(&coefs[s * 5], PEQ_PEAK, 100.0 * (s + 1), 6.0, 1.0);
+
+  for (uint8_t stages = 1; stages <= PEQ_MAX_STAGES; stages++)
+  {
+    arm_biquad_cascade_df1_init_q31(&cascade, stages, coefs, state, PEQ_POST_SHIFT);
+    cycles = 0;
+    for (uint16_t n = 0; n < BENCH_BLOCKS; n++)
+    {
+      for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+        data[i] = (int32_t)(i * 512 - 32768 + n) << (16 - PEQ_HEADROOM_BITS);
+
+      uint32_t start = ARM_DWT_CYCCNT;
+      arm_biquad_cascade_df1_q31(&cascade, data, data, AUDIO_BLOCK_SAMPLES);
+      cycles += ARM_DWT_CYCCNT - start;
+    }
+    Serial.print(F("Parametric EQ "));
+    Serial.print(stages);
+    printBenchResult(" stages", cycles);
+    Serial.print(F("  per stage: "));
+    Serial.print((float)cycles / BENCH_BLOCKS / stages, 0);
+    Serial.println(F(" cycles/block"));
+  }
+}
+
+
+
+void runBenchmarks()
+{
+  Serial.println(F("Benchmarks"));
+  startCycleCounter();
+
+  // keep the audio interrupt from skewing the results
+  AudioNoInterrupts();
+  benchWaveshaper();
+  benchParametricEQ();
+  AudioInterrupts();
+
+  Serial.println();
+}
+
+
+
+// average cpu usage of the whole graph and of the nodes that
+// should go quiet on silent blocks
+void readIdleCpu(const char* title)
+{
+  const uint8_t numNodes = 7;
+  AudioStream *nodes[numNodes] = {&mixer1, &chorus1, &flange1, &filter1, &multiply1, &mixer8_1, &mixer4};
+  const char *names[numNodes] = {"mixer1", "chorus1", "flange1", "filter1", "multiply1", "mixer8_1", "mixer4"};
+  float nodeUsage[numNodes] = {0};
+  float total = 0;
+
+  // let the gate release and the meters settle
+  delay(500);
+
+  for (uint16_t n = 0; n < IDLE_READINGS; n++)
+  {
+    total += AudioProcessorUsage();
+    for (uint8_t i = 0; i < numNodes; i++)
+      nodeUsage[i] += nodes[i]->processorUsage();
+    delay(IDLE_READ_MS);
+  }
+
+  Serial.println(title);
+  Serial.print(F("  Total     : ")); Serial.println(total / IDLE_READINGS);
+  for (uint8_t i = 0; i < numNodes; i++)
+  {
+    Serial.print(F("  "));
+    Serial.print(names[i]);
+    Serial.print(F(" : "));
+    Serial.println(nodeUsage[i] / IDLE_READINGS);
+  }
+}
+
+
+
+void measureIdleCpu()
+{
+  Serial.println(F("Idle CPU - don't play while measuring"));
+
+  // before: tone generator always feeding mixer1 and no gate,
+  // so every node gets a block every update
+  gate1.setBypass(true);
+  gate1.silenceDetect(false);
+  sine2.amplitude(0.5);
+  readIdleCpu("Silent blocks processed:");
+
+  // after: nothing sent into the chain when it's quiet
+  gate1.setBypass(false);
+  gate1.silenceDetect(true);
+  sine2.amplitude(0);
+  readIdleCpu("Silent blocks skipped:");
+
+  // back to the current settings
+  gate1.setBypass(!noiseGate.getStatus());
+  Serial.println();
+}
+
+#endif
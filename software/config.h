@@ -30,13 +30,16 @@ void showEEPROM();
 
 // if the first byte of stored data matches this, it
 // is assumed valid data for this version
-#define EEPROM_VERSION 183
+#define EEPROM_VERSION 193
 #define EEPROM_ADDR    0
 
 // equalizer bands
 #define NUM_EQ_BANDS  5
 enum eqBands {BASS, MID_BASS, MIDRANGE, MID_TREBLE, TREBLE};
 
+// software parametric equalizer bands
+#define NUM_PEQ_BANDS PEQ_MAX_STAGES
+
 #define HEADPHONE_OUTPUT_LEVEL 0.7
 #define LINEOUT_AUDIO_LEVEL    8
 
@@ -55,6 +58,10 @@ struct Config
   float   eqBandVals[5];
   int     updateFilter[5];
 
+  float   peqFreq[NUM_PEQ_BANDS];
+  float   peqGain[NUM_PEQ_BANDS];
+  float   peqQ[NUM_PEQ_BANDS];
+
   bool    compEnabled;
   uint8_t compGain;
   uint8_t compResponse;
@@ -62,6 +69,11 @@ struct Config
   float   compThreshold;
   float   compAttack;
   float   compDecay;
+  float   compRatio;
+  float   compKnee;
+  float   compAttackTime;
+  float   compReleaseTime;
+  bool    compLookahead;
 
   float   tremoloVolume;
   float   tremoloSpeed;
@@ -81,8 +93,28 @@ struct Config
   float   chorusVoices;
   float   chorusVolume;
 
+  uint8_t shapeCurve;
+  float   shapeDrive;
+  float   shapeVolume;
+
+  float   gateThreshold;
+  float   gateHysteresis;
+  float   gateHold;
+  float   gateRelease;
+
   uint8_t inputLevel;
 
+  bool    tunerMute;
+  float   tunerRef;
+  uint8_t tunerView;
+  uint8_t tuning;
+
+  int16_t pedalHeel;
+  int16_t pedalToe;
+  uint8_t pedalCurve;
+
+  float   looperVolume;
+
   uint8_t lastMenu;
 };
 
@@ -103,6 +135,16 @@ void loadDefaults()
   cfg.eqBandVals[MID_TREBLE]  = 0.0;
   cfg.eqBandVals[TREBLE]      = 0.0;
 
+  // software equalizer - octave spaced bands, all flat
+  const float peqFreqs[NUM_PEQ_BANDS] = {80, 160, 320, 640, 1250, 2500, 5000, 10000};
+  for (uint8_t i = 0; i < NUM_PEQ_BANDS; i++)
+  {
+    cfg.peqFreq[i] = peqFreqs[i];   // 20 to 20k Hz
+    cfg.peqGain[i] = 0.0;           // +/- 12 dB
+    cfg.peqQ[i]    = 1.0;           // 0.3 to 10
+  }
+  cfg.peqQ[0] = cfg.peqQ[NUM_PEQ_BANDS - 1] = 0.707;   // shelves
+
   // compressor
   cfg.compEnabled   = false;
   cfg.compGain      = 1;       // 0 = 0db, 1 = 6db, 2 = 12db
@@ -112,6 +154,13 @@ void loadDefaults()
   cfg.compAttack    = 3.0;     // db per sec
   cfg.compDecay     = 4.0;     // db per sec
 
+  // software compressor
+  cfg.compRatio       = 4.0;   // 1.0 to 100
+  cfg.compKnee        = 6.0;   // dB, 0 = hard knee
+  cfg.compAttackTime  = 5.0;   // 0.1 to 50 ms
+  cfg.compReleaseTime = 200;   // 10 to 1000 ms
+  cfg.compLookahead   = false; // delay audio 1 block
+
   // tremolo
   cfg.tremoloVolume = 0.8;     // 0 to 1.0
   cfg.tremoloSpeed  = 3.0;     // 0.5 to 8.0 Hz
@@ -137,9 +186,34 @@ void loadDefaults()
   cfg.chorusVoices    = 2;
   cfg.chorusVolume    = 0.5;
 
+  // waveshaper
+  cfg.shapeCurve      = 0;     // 0 = soft, 1 = hard, 2 = tube, 3 = fold
+  cfg.shapeDrive      = 4.0;   // 1.0 to 16.0
+  cfg.shapeVolume     = 0.5;   // 0 to 1.0
+
+  // noise gate
+  cfg.gateThreshold   = -60;   // 0 to -96 dBFS
+  cfg.gateHysteresis  = 6.0;   // dB below threshold to close
+  cfg.gateHold        = 50;    // ms
+  cfg.gateRelease     = 100;   // ms
+
   // input level
   cfg.inputLevel      = 5;     // 0 to 15, 5 = 1.33vpp
 
+  // tuner
+  cfg.tunerMute       = false; // mute outputs while tuning
+  cfg.tunerRef        = 440;   // A4, 430 to 450 Hz
+  cfg.tuning          = 0;     // 0 = chromatic, see tuner.h
+  cfg.tunerView       = 0;     // 0 = bar, 1 = strobe, 2 = strum
+
+  // wah-wah pedal, raw 12 bit readings, see pedal.h
+  cfg.pedalHeel       = 0;
+  cfg.pedalToe        = 4095;
+  cfg.pedalCurve      = 0;     // 0 = linear
+
+  // looper, see Looper.h
+  cfg.looperVolume    = 1.0;
+
   // general
   cfg.lastMenu        = 0;
 }
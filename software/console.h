@@ -0,0 +1,243 @@
+/******************************************************
+   console.h - line commands for the serial console
+
+   version 1.0   Oct 2026
+
+   Reads & changes any setting in the param registry
+   (params.h) by name, so a PC can drive every setting
+   from a script:
+
+     set reverb.roomsize 0.6
+     set delay.time[0] 250 delay.time[1] 500
+     get delay.time[1] reverb.damping
+     list            all params with value & range
+     list reverb     just the ones starting with "reverb"
+     store 2         save the settings as preset 2
+     recall 2        load preset 2
+
+   Replies are one line per param,  name = value , with
+   values constrained to the range. Problems are reported
+   on a line starting with "error:". All the params in one
+   set are changed before the effects are updated, so each
+   effect is only updated once. A set or get with more than
+   CONSOLE_MAX_ARGS words after it is refused as a whole.
+
+   A line with just one letter is run as a single letter
+   command, same as before (see doSerialCommands). Any other
+   line is refused with "error: unknown command", so a typo
+   can't run its letters as commands.
+
+ ******************************************************/
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "params.h"
+
+
+#define CONSOLE_LINE_LENGTH  80
+#define CONSOLE_MAX_ARGS     16
+
+// run a line without a line ending after this
+#define CONSOLE_TIMEOUT      100
+
+
+// prototypes
+uint8_t splitLine(char *line, char **args, uint8_t maxArgs);
+bool doLineCommand(char *line);
+
+
+
+// split into words in place, returns the number found,
+// only the first maxArgs are kept
+uint8_t splitLine(char *line, char **args, uint8_t maxArgs)
+{
+  uint8_t n = 0;
+  char *word = strtok(line, " \t");
+
+  while (word)
+  {
+    if (n < maxArgs)
+      args[n] = word;
+    n++;
+    word = strtok(NULL, " \t");
+  }
+  return n;
+}
+
+
+
+void printParam(uint8_t id)
+{
+  Serial.print(params[id].name);
+  Serial.print(" = ");
+  if (params[id].type == PARAM_FLOAT)
+    Serial.println(getParam(id), 3);
+  else
+    Serial.println((int)getParam(id));
+}
+
+
+
+void consoleError(const char *msg, const char *arg)
+{
+  Serial.print(F("error: "));
+  Serial.print(msg);
+  Serial.println(arg);
+}
+
+
+
+// name value pairs, checked before any are set
+void consoleSet(char **args, uint8_t n)
+{
+  uint8_t ids[CONSOLE_MAX_ARGS / 2];
+  float values[CONSOLE_MAX_ARGS / 2];
+
+  if (n == 0 || n % 2)
+  {
+    consoleError("usage: set <param> <value> ...", "");
+    return;
+  }
+
+  for (uint8_t i = 0; i < n / 2; i++)
+  {
+    int16_t id = findParam(args[2 * i]);
+    if (id < 0)
+    {
+      consoleError("unknown param ", args[2 * i]);
+      return;
+    }
+
+    char *end;
+    values[i] = strtod(args[2 * i + 1], &end);
+    if (end == args[2 * i + 1] || *end)
+    {
+      consoleError("bad value ", args[2 * i + 1]);
+      return;
+    }
+    ids[i] = id;
+  }
+
+  for (uint8_t i = 0; i < n / 2; i++)
+    setParam(ids[i], values[i], false);
+  applyParams(ids, n / 2);
+
+  for (uint8_t i = 0; i < n / 2; i++)
+    printParam(ids[i]);
+}
+
+
+
+void consoleGet(char **args, uint8_t n)
+{
+  if (n == 0)
+  {
+    consoleError("usage: get <param> ...", "");
+    return;
+  }
+
+  for (uint8_t i = 0; i < n; i++)
+  {
+    int16_t id = findParam(args[i]);
+    if (id < 0)
+      consoleError("unknown param ", args[i]);
+    else
+      printParam(id);
+  }
+}
+
+
+
+void consoleList(const char *prefix)
+{
+  uint8_t len = prefix ? strlen(prefix) : 0;
+
+  for (uint8_t id = 0; id < NUM_PARAMS; id++)
+  {
+    if (len && strncmp(params[id].name, prefix, len) != 0)
+      continue;
+
+    Serial.print(params[id].name);
+    Serial.print(" = ");
+    if (params[id].type == PARAM_FLOAT)
+      Serial.print(getParam(id), 3);
+    else
+      Serial.print((int)getParam(id));
+    Serial.print("   (");
+    Serial.print(params[id].minVal, 2);
+    Serial.print(" to ");
+    Serial.print(params[id].maxVal, 2);
+    Serial.println(")");
+  }
+}
+
+
+
+#ifdef USE_SD_CARD
+// lib, lib save <name>, lib load <name>
+void consoleLibrary(char **args, uint8_t n)
+{
+  if (n == 0)
+    library.list();
+  else if (strcmp(args[0], "save") == 0 && n == 2)
+  {
+    if (!library.save(args[1]))
+      consoleError("can't save ", args[1]);
+  }
+  else if (strcmp(args[0], "load") == 0 && n == 2)
+  {
+    int16_t i = library.find(args[1]);
+    if (i < 0 || !library.load(i))
+      consoleError("no preset ", args[1]);
+  }
+  else
+    consoleError("usage: lib [save|load <name>]", "");
+}
+#endif
+
+
+
+// false if the line isn't a line command
+bool doLineCommand(char *line)
+{
+  char *args[CONSOLE_MAX_ARGS + 1];
+  uint8_t n = splitLine(line, args, CONSOLE_MAX_ARGS + 1);
+
+  if (n == 0)
+    return false;
+
+  // the rest of the words weren't kept
+  if (n > CONSOLE_MAX_ARGS + 1 && (strcmp(args[0], "set") == 0 || strcmp(args[0], "get") == 0))
+  {
+    consoleError("too many params", "");
+    return true;
+  }
+
+  if (strcmp(args[0], "set") == 0)
+    consoleSet(&args[1], n - 1);
+  else if (strcmp(args[0], "get") == 0)
+    consoleGet(&args[1], n - 1);
+  else if (strcmp(args[0], "list") == 0)
+    consoleList(n > 1 ? args[1] : NULL);
+  else if (strcmp(args[0], "store") == 0 && n == 2)
+  {
+    if (!savePreset(atoi(args[1])))
+      consoleError("can't store preset ", args[1]);
+  }
+  else if (strcmp(args[0], "recall") == 0 && n == 2)
+  {
+    if (!loadPreset(atoi(args[1])))
+      consoleError("no preset ", args[1]);
+  }
+#ifdef USE_SD_CARD
+  else if (strcmp(args[0], "lib") == 0)
+    consoleLibrary(&args[1], n - 1);
+#endif
+  else
+    return false;
+
+  return true;
+}
+
+#endif
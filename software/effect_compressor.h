@@ -0,0 +1,307 @@
+/**************************************************************
+    effect_compressor.h - software compressor node
+
+    version 1.0   Oct 2026
+
+    Audio library node replacing the SGTL5000 auto volume
+    control. The detector, gain computer and attack/release
+    smoothing all run once per block in the log domain using
+    fixed point log2/exp2 approximations, so the cost per
+    block is one pass to find the peak and one pass to apply
+    the gain, no matter how the controls are set.
+
+    Internally levels are log2 units in Q16 (1 unit = 6.02 dB)
+
+      over  = level - threshold
+      gr    = (1/ratio - 1) * over                 above the knee
+            = (1/ratio - 1) * (over + k/2)^2 / 2k  inside the knee
+      gr is smoothed with the attack or release time,
+      then gain = exp2(makeup + gr) is ramped across the block
+
+    Lookahead delays the audio by one block (2.9 ms) so the
+    gain is already reduced when a transient arrives.
+
+    readGainReduction() returns the largest gain reduction,
+    in dB, since it was last called (for metering).
+
+ **************************************************************/
+
+#ifndef EFFECT_COMPRESSOR_H
+#define EFFECT_COMPRESSOR_H
+
+#include <AudioStream.h>
+#include <dspinst.h>
+
+
+// 1.0 in Q16
+#define COMP_Q16_ONE      65536
+
+// dB per log2 unit
+#define COMP_DB_PER_LOG2  6.0206
+
+// block time in ms, for the attack & release coefficients
+#define COMP_BLOCK_MS     (1000.0 * AUDIO_BLOCK_SAMPLES / AUDIO_SAMPLE_RATE_EXACT)
+
+// log2 level used for a silent block, about -150 dBFS
+#define COMP_SILENCE      (-25 * COMP_Q16_ONE)
+
+
+
+// log2 of x in Q16 for x > 0, relative to x = 1
+static inline int32_t log2Q16(uint32_t x)
+{
+  int32_t e = 31 - __builtin_clz(x);
+
+  // fractional part of the mantissa, 0 to 1.0 in Q16
+  int32_t f = (e >= 16 ? (x >> (e - 16)) : (x << (16 - e))) - COMP_Q16_ONE;
+
+  // log2(1 + f) ~= f * (1.3465 - 0.3465 * f), max error 0.008
+  int32_t k = 88244 - ((22708 * f) >> 16);
+  return (e << 16) + (int32_t)(((int64_t)f * k) >> 16);
+}
+
+
+
+// 2^x for x in Q16, result in Q16
+static inline int32_t exp2Q16(int32_t x)
+{
+  int32_t e = x >> 16;
+  int32_t f = x & 0xFFFF;
+
+  // 2^f ~= 1 + f * (0.6565 + 0.3435 * f), max error 0.4%
+  int32_t m = COMP_Q16_ONE + (((uint32_t)f * (43025 + ((22511 * f) >> 16))) >> 16);
+
+  if (e >= 14)
+    return INT32_MAX;
+  if (e < -16)
+    return 0;
+  return e >= 0 ? m << e : m >> -e;
+}
+
+
+
+class AudioEffectCompressor : public AudioStream
+{
+  public:
+    AudioEffectCompressor() : AudioStream(1, inputQueueArray)
+    {
+      bypass = true;
+      useLookahead = false;
+      delayed = NULL;
+      level = COMP_SILENCE;
+      reduction = 0;
+      peakReduction = 0;
+      lastGain = COMP_Q16_ONE;
+      threshold(-20.0);
+      ratio(4.0);
+      knee(6.0);
+      attack(5.0);
+      release(200.0);
+      makeupGain(0);
+    }
+
+    // threshold in dBFS, 0 to -96
+    void threshold(float dB)
+    {
+      thresholdLevel = (int32_t)(dB / COMP_DB_PER_LOG2 * COMP_Q16_ONE);
+    }
+
+    // 1.0 (off) to 100.0 (limiter)
+    void ratio(float r)
+    {
+      r = constrain(r, 1.0, 100.0);
+      slope = (int32_t)((1.0 / r - 1.0) * COMP_Q16_ONE);
+    }
+
+    // knee width in dB, 0 = hard knee
+    void knee(float dB)
+    {
+      kneeWidth = (int32_t)(constrain(dB, 0, 48.0) / COMP_DB_PER_LOG2 * COMP_Q16_ONE);
+    }
+
+    // time to reach ~63% of the new gain reduction
+    void attack(float milliseconds)
+    {
+      attackCoef = timeToCoef(milliseconds);
+    }
+
+    void release(float milliseconds)
+    {
+      releaseCoef = timeToCoef(milliseconds);
+    }
+
+    // 0 to 24 dB
+    void makeupGain(float dB)
+    {
+      makeup = (int32_t)(constrain(dB, 0, 24.0) / COMP_DB_PER_LOG2 * COMP_Q16_ONE);
+    }
+
+    void lookahead(bool state)
+    {
+      useLookahead = state;
+    }
+
+    // true = pass audio thru untouched
+    void setBypass(bool state)
+    {
+      bypass = state;
+    }
+
+    // largest gain reduction since last read, in dB (positive)
+    float readGainReduction()
+    {
+      __disable_irq();
+      int32_t gr = peakReduction;
+      peakReduction = reduction;
+      __enable_irq();
+      return -gr * COMP_DB_PER_LOG2 / COMP_Q16_ONE;
+    }
+
+    virtual void update(void);
+    using AudioStream::release;
+
+  private:
+    int32_t timeToCoef(float milliseconds)
+    {
+      if (milliseconds < COMP_BLOCK_MS)
+        return COMP_Q16_ONE;
+      return (int32_t)((1.0 - expf(-COMP_BLOCK_MS / milliseconds)) * COMP_Q16_ONE);
+    }
+
+    int32_t gainComputer(int32_t in);
+    void applyGain(audio_block_t *block, int32_t gain);
+
+    audio_block_t *inputQueueArray[1];
+    audio_block_t *delayed;
+    volatile bool bypass;
+    volatile bool useLookahead;
+
+    // all in log2 Q16
+    int32_t thresholdLevel;
+    int32_t kneeWidth;
+    int32_t makeup;
+    int32_t level;
+    int32_t reduction;
+    int32_t peakReduction;
+
+    int32_t slope;
+    int32_t attackCoef;
+    int32_t releaseCoef;
+
+    // linear Q16
+    int32_t lastGain;
+};
+
+
+
+// gain reduction for a given input level, both log2 Q16
+int32_t AudioEffectCompressor :: gainComputer(int32_t in)
+{
+  int32_t over = in - thresholdLevel;
+
+  if (2 * over <= -kneeWidth)
+    return 0;
+
+  if (2 * over >= kneeWidth)
+    return ((int64_t)slope * over) >> 16;
+
+  // inside the knee, quadratic blend between the two slopes
+  int32_t t = over + kneeWidth / 2;
+  int32_t curve = ((int64_t)t * t) / (2 * kneeWidth);
+  return ((int64_t)slope * curve) >> 16;
+}
+
+
+
+// ramp from the last gain to the new one across the block
+void AudioEffectCompressor :: applyGain(audio_block_t *block, int32_t gain)
+{
+  int32_t g = lastGain;
+  int32_t step = (gain - lastGain) / AUDIO_BLOCK_SAMPLES;
+
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+  {
+    g += step;
+    int32_t y = ((int64_t)block->data[i] * g) >> 16;
+    block->data[i] = signed_saturate_rshift(y, 16, 0);
+  }
+  lastGain = gain;
+}
+
+
+
+void AudioEffectCompressor :: update(void)
+{
+  audio_block_t *block;
+  int32_t peak = 0;
+
+  block = receiveWritable();
+
+  if (bypass)
+  {
+    if (delayed)
+    {
+      release(delayed);
+      delayed = NULL;
+    }
+    if (block)
+    {
+      transmit(block);
+      release(block);
+    }
+    reduction = 0;
+    lastGain = COMP_Q16_ONE;
+    return;
+  }
+
+  // detector, peak level of the new block
+  if (block)
+  {
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+    {
+      int32_t s = block->data[i];
+      if (s < 0)
+        s = -s;
+      if (s > peak)
+        peak = s;
+    }
+  }
+
+  // log2 of peak relative to full scale (32768 = 2^15)
+  level = peak ? log2Q16(peak) - (15 << 16) : COMP_SILENCE;
+
+  // attack when more reduction is needed, otherwise release
+  int32_t target = gainComputer(level);
+  int32_t coef = target < reduction ? attackCoef : releaseCoef;
+  reduction += ((int64_t)(target - reduction) * coef) >> 16;
+
+  if (reduction < peakReduction)
+    peakReduction = reduction;
+
+  int32_t gain = exp2Q16(makeup + reduction);
+
+  // with lookahead, the new gain is applied to the previous block
+  audio_block_t *out = block;
+  if (useLookahead)
+  {
+    out = delayed;
+    delayed = block;
+  }
+  else if (delayed)
+  {
+    release(delayed);
+    delayed = NULL;
+  }
+
+  if (!out)
+  {
+    lastGain = gain;
+    return;
+  }
+
+  applyGain(out, gain);
+  transmit(out);
+  release(out);
+}
+
+#endif
@@ -0,0 +1,397 @@
+/**************************************************************
+    effect_looper.h - phrase looper in the external SRAM
+
+    version 1.0   Oct 2026
+
+    Audio library node that records the input into its part
+    of the 23LC1024 (see sram.h) and plays it back in a loop,
+    with overdub & one level of undo.
+
+    Commands are queued and take effect in order at the start
+    of the next block, so the loop points are accurate to one
+    block (128 samples, ~2.9 ms): a press is late by up to a
+    block, the same for the record & the stop. Two presses in
+    one block are both seen. The length is kept in samples,
+    so a loop cut short by the end of memory still wraps in
+    the middle of a block.
+
+    Undo: from the start of an overdub, one pass of the loop
+    is copied to a second buffer before it's changed. After
+    that the two buffers can be swapped, undo & redo, however
+    long the overdub goes on. Both buffers have to fit, so
+    loops longer than half the memory have no undo. Undo
+    pressed before the pass is copied happens when it is.
+
+    The output is only the loop, the live signal isn't
+    passed through. Nothing is done unless recording or
+    playing.
+
+    Built with LOOPER_SRAM_STUB, sramRead() & sramWrite() are
+    left out for the host test (tests/looper_test.cpp) to
+    supply, so it runs without the chip.
+
+ **************************************************************/
+
+#ifndef EFFECT_LOOPER_H
+#define EFFECT_LOOPER_H
+
+#include <AudioStream.h>
+#ifndef LOOPER_SRAM_STUB
+#include <SPI.h>
+#endif
+#include <dspinst.h>
+#include "sram.h"
+
+
+// 23LC1024 commands, sequential mode is the default
+#define SRAM_READ     0x03
+#define SRAM_WRITE    0x02
+
+// states
+#define LOOP_EMPTY        0
+#define LOOP_RECORDING    1
+#define LOOP_PLAYING      2
+#define LOOP_OVERDUBBING  3
+#define LOOP_STOPPED      4
+
+// commands
+#define LOOP_CMD_RECORD   1     // record / overdub
+#define LOOP_CMD_PLAY     2     // play / stop
+#define LOOP_CMD_UNDO     3     // undo / redo the last overdub
+#define LOOP_CMD_CLEAR    4
+
+// commands waiting for the next block, far more than can be
+// pressed in one
+#define LOOP_QUEUE_SIZE   8
+
+
+
+class AudioEffectLooper : public AudioStream
+{
+  public:
+    AudioEffectLooper(uint32_t begin, uint32_t samples) : AudioStream(1, inputQueueArray)
+    {
+      memBegin = begin;
+      memSamples = samples;
+      queueHead = 0;
+      queueTail = 0;
+      clear();
+    }
+
+    // applied at the start of the next block, after any that
+    // are already waiting. Only call from the main loop.
+    void command(uint8_t cmd)
+    {
+      uint8_t next = (queueHead + 1) % LOOP_QUEUE_SIZE;
+      if (next == queueTail)
+        return;
+
+      queue[queueHead] = cmd;
+      queueHead = next;
+    }
+
+    uint8_t state()
+    {
+      return loopState;
+    }
+
+    // loop length in samples
+    uint32_t length()
+    {
+      return loopLength;
+    }
+
+    uint32_t position()
+    {
+      return pos;
+    }
+
+    bool canUndo()
+    {
+      return undoAvail || undoPending;
+    }
+
+    virtual void update(void);
+
+  private:
+    audio_block_t *inputQueueArray[1];
+    uint32_t memBegin;
+    uint32_t memSamples;
+
+    // written by command(), read by update()
+    uint8_t queue[LOOP_QUEUE_SIZE];
+    volatile uint8_t queueHead;
+    volatile uint8_t queueTail;
+
+    volatile uint8_t loopState;
+    volatile uint32_t loopLength;
+    volatile uint32_t pos;
+
+    // the loop & the undo copy, swapped by undo
+    uint32_t current;
+    uint32_t other;
+
+    // copying a pass for undo
+    bool layerOpen;
+    uint32_t layerRemaining;
+    volatile bool undoAvail;
+    volatile bool undoPending;
+
+    void clear();
+    void doCommand(uint8_t cmd);
+    void openLayer();
+    void record(const int16_t *in);
+    void play(const int16_t *in, int16_t *out);
+    void sramRead(uint32_t sample, int16_t *data, uint16_t n);
+    void sramWrite(uint32_t sample, const int16_t *data, uint16_t n);
+};
+
+
+
+void AudioEffectLooper :: clear()
+{
+  loopState = LOOP_EMPTY;
+  loopLength = 0;
+  pos = 0;
+  current = memBegin;
+  other = memBegin + memSamples / 2;
+  layerOpen = false;
+  undoAvail = false;
+  undoPending = false;
+}
+
+
+
+// called from update, in the audio interrupt
+void AudioEffectLooper :: doCommand(uint8_t cmd)
+{
+  switch (cmd)
+  {
+    case LOOP_CMD_RECORD:
+      if (loopState == LOOP_EMPTY)
+      {
+        pos = 0;
+        loopState = LOOP_RECORDING;
+      }
+      else if (loopState == LOOP_RECORDING)
+        doCommand(LOOP_CMD_PLAY);
+      else if (loopState == LOOP_PLAYING)
+      {
+        openLayer();
+        loopState = LOOP_OVERDUBBING;
+      }
+      else if (loopState == LOOP_OVERDUBBING)
+        loopState = LOOP_PLAYING;
+      else if (loopState == LOOP_STOPPED)
+      {
+        pos = 0;
+        openLayer();
+        loopState = LOOP_OVERDUBBING;
+      }
+      break;
+
+    case LOOP_CMD_PLAY:
+      if (loopState == LOOP_RECORDING)
+      {
+        // close the loop
+        loopLength = pos;
+        pos = 0;
+        loopState = loopLength ? LOOP_PLAYING : LOOP_EMPTY;
+      }
+      else if (loopState == LOOP_PLAYING || loopState == LOOP_OVERDUBBING)
+      {
+        // a part copied pass can't be undone
+        if (layerOpen)
+        {
+          layerOpen = false;
+          undoAvail = false;
+          undoPending = false;
+        }
+        loopState = LOOP_STOPPED;
+      }
+      else if (loopState == LOOP_STOPPED)
+      {
+        pos = 0;
+        loopState = LOOP_PLAYING;
+      }
+      break;
+
+    case LOOP_CMD_UNDO:
+      if (loopState == LOOP_OVERDUBBING)
+        loopState = LOOP_PLAYING;
+
+      if (layerOpen)
+        undoPending = !undoPending;
+      else if (undoAvail)
+      {
+        uint32_t t = current;
+        current = other;
+        other = t;
+      }
+      break;
+
+    case LOOP_CMD_CLEAR:
+      clear();
+      break;
+  }
+}
+
+
+
+// start copying a pass for undo, if both buffers fit
+void AudioEffectLooper :: openLayer()
+{
+  if (layerOpen || loopLength > memSamples / 2)
+    return;
+
+  layerOpen = true;
+  layerRemaining = loopLength;
+  undoAvail = false;
+  undoPending = false;
+}
+
+
+
+// stops by itself when the memory is full
+void AudioEffectLooper :: record(const int16_t *in)
+{
+  uint16_t n = min((uint32_t)AUDIO_BLOCK_SAMPLES, memSamples - pos);
+
+  sramWrite(current + pos, in, n);
+  pos += n;
+
+  if (pos == memSamples)
+    doCommand(LOOP_CMD_PLAY);
+}
+
+
+
+// in pieces that end where the loop wraps or the undo copy
+// is complete
+void AudioEffectLooper :: play(const int16_t *in, int16_t *out)
+{
+  int16_t mixed[AUDIO_BLOCK_SAMPLES];
+  uint16_t done = 0;
+
+  while (done < AUDIO_BLOCK_SAMPLES)
+  {
+    uint32_t n = min((uint32_t)(AUDIO_BLOCK_SAMPLES - done), loopLength - pos);
+    if (layerOpen)
+      n = min(n, layerRemaining);
+
+    sramRead(current + pos, &out[done], n);
+
+    if (loopState == LOOP_OVERDUBBING)
+    {
+      for (uint16_t i = 0; i < n; i++)
+        mixed[i] = saturate16(out[done + i] + in[done + i]);
+      sramWrite(current + pos, mixed, n);
+    }
+
+    if (layerOpen)
+    {
+      sramWrite(other + pos, &out[done], n);
+      layerRemaining -= n;
+    }
+
+    pos += n;
+    done += n;
+    if (pos == loopLength)
+      pos = 0;
+
+    // a whole pass is copied, the rest of the overdub only
+    // changes the loop
+    if (layerOpen && layerRemaining == 0)
+    {
+      layerOpen = false;
+      undoAvail = true;
+      if (undoPending)
+      {
+        undoPending = false;
+        doCommand(LOOP_CMD_UNDO);
+      }
+    }
+  }
+}
+
+
+
+#ifndef LOOPER_SRAM_STUB
+void AudioEffectLooper :: sramRead(uint32_t sample, int16_t *data, uint16_t n)
+{
+  uint32_t addr = sample << 1;
+
+  SPI.beginTransaction(SPISettings(20000000, MSBFIRST, SPI_MODE0));
+  digitalWrite(SRAM_CS_PIN, LOW);
+  SPI.transfer16((SRAM_READ << 8) | (addr >> 16));
+  SPI.transfer16(addr & 0xFFFF);
+  for (uint16_t i = 0; i < n; i++)
+    data[i] = SPI.transfer16(0);
+  digitalWrite(SRAM_CS_PIN, HIGH);
+  SPI.endTransaction();
+}
+
+
+
+void AudioEffectLooper :: sramWrite(uint32_t sample, const int16_t *data, uint16_t n)
+{
+  uint32_t addr = sample << 1;
+
+  SPI.beginTransaction(SPISettings(20000000, MSBFIRST, SPI_MODE0));
+  digitalWrite(SRAM_CS_PIN, LOW);
+  SPI.transfer16((SRAM_WRITE << 8) | (addr >> 16));
+  SPI.transfer16(addr & 0xFFFF);
+  for (uint16_t i = 0; i < n; i++)
+    SPI.transfer16(data[i]);
+  digitalWrite(SRAM_CS_PIN, HIGH);
+  SPI.endTransaction();
+}
+#endif
+
+
+
+// a missing input block is silence
+void AudioEffectLooper :: update(void)
+{
+  audio_block_t *in;
+  audio_block_t *out;
+  static const int16_t silence[AUDIO_BLOCK_SAMPLES] = {0};
+
+  while (queueTail != queueHead)
+  {
+    doCommand(queue[queueTail]);
+    queueTail = (queueTail + 1) % LOOP_QUEUE_SIZE;
+  }
+
+  in = receiveReadOnly();
+  const int16_t *data = in ? in->data : silence;
+
+  switch (loopState)
+  {
+    case LOOP_RECORDING:
+      record(data);
+      break;
+
+    case LOOP_PLAYING:
+    case LOOP_OVERDUBBING:
+      // keep time even without a block to send
+      out = allocate();
+      if (out)
+      {
+        play(data, out->data);
+        transmit(out);
+        release(out);
+      }
+      else
+      {
+        int16_t scratch[AUDIO_BLOCK_SAMPLES];
+        play(data, scratch);
+      }
+      break;
+  }
+
+  if (in)
+    release(in);
+}
+
+#endif
@@ -0,0 +1,225 @@
+/**************************************************************
+    effect_noise_gate.h - block based noise gate node
+
+    version 1.0   Oct 2026
+
+    Audio library node that mutes its input when the signal
+    falls below a threshold. All of the decisions are made
+    once per block from a running RMS level, only the gain
+    ramp is applied per sample.
+
+    threshold:  gate opens when the RMS level rises above this
+    hysteresis: gate closes when the level falls this many dB
+                below the threshold, so it doesn't chatter
+    hold:       time the gate stays open after the level drops
+    release:    time to fade from full level to silence
+
+    When the gate is fully closed no block is transmitted. The
+    audio library treats a missing block as silence, so nodes
+    downstream can skip their processing. Mixers, chorus, flange,
+    filter and multiply all return early on a missing block, while
+    freeverb and the external delay process it as zeros so their
+    tails still decay.
+
+    Silence detection does the same when the gate is bypassed,
+    but only for blocks that are (nearly) digital silence.
+
+ **************************************************************/
+
+#ifndef EFFECT_NOISE_GATE_H
+#define EFFECT_NOISE_GATE_H
+
+#include <AudioStream.h>
+
+
+// block rate used for the time constants
+#define GATE_BLOCKS_PER_SEC  (AUDIO_SAMPLE_RATE_EXACT / AUDIO_BLOCK_SAMPLES)
+
+// gain is Q15, 32768 = unity
+#define GATE_UNITY_GAIN      32768
+
+// largest sample in a block treated as digital silence
+#define GATE_SILENCE_LEVEL   4
+
+
+
+// true if every sample in the block is within +/- limit,
+// exits on the first loud sample so playing costs almost nothing
+static inline bool isSilentBlock(const int16_t *data, int16_t limit)
+{
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+  {
+    if (data[i] > limit || data[i] < -limit)
+      return false;
+  }
+  return true;
+}
+
+
+
+class AudioEffectNoiseGate : public AudioStream
+{
+  public:
+    AudioEffectNoiseGate() : AudioStream(1, inputQueueArray)
+    {
+      bypass = true;
+      skipSilence = true;
+      gateOpen = true;
+      gain = GATE_UNITY_GAIN;
+      level = 0;
+      holdCount = 0;
+      threshold(-60.0, 6.0);
+      hold(50);
+      release(100);
+    }
+
+    // threshold in dBFS, hysteresis in dB
+    void threshold(float dB, float hysteresisdB)
+    {
+      // compare mean squares, avoids a sqrt or log per block
+      float openLevel  = powf(10.0, dB / 10.0);
+      float closeLevel = powf(10.0, (dB - hysteresisdB) / 10.0);
+      __disable_irq();
+      openThreshold  = openLevel;
+      closeThreshold = closeLevel;
+      __enable_irq();
+    }
+
+    void hold(float milliseconds)
+    {
+      holdBlocks = (uint16_t)(milliseconds * GATE_BLOCKS_PER_SEC / 1000.0);
+    }
+
+    void release(float milliseconds)
+    {
+      float blocks = milliseconds * GATE_BLOCKS_PER_SEC / 1000.0;
+      if (blocks < 1.0)
+        blocks = 1.0;
+      releaseStep = (int32_t)(GATE_UNITY_GAIN / blocks);
+    }
+
+    // true = pass audio thru untouched
+    void setBypass(bool state)
+    {
+      bypass = state;
+    }
+
+    // true = don't transmit blocks of digital silence
+    void silenceDetect(bool state)
+    {
+      skipSilence = state;
+    }
+
+    bool isOpen()
+    {
+      return gateOpen;
+    }
+
+    // running RMS level, 0 to 1.0
+    float readLevel()
+    {
+      return sqrtf(level);
+    }
+
+    virtual void update(void);
+    using AudioStream::release;
+
+  private:
+    audio_block_t *inputQueueArray[1];
+    volatile bool bypass;
+    volatile bool skipSilence;
+    volatile bool gateOpen;
+    float openThreshold;
+    float closeThreshold;
+    float level;
+    uint16_t holdBlocks;
+    uint16_t holdCount;
+    int32_t releaseStep;
+    int32_t gain;
+};
+
+
+
+void AudioEffectNoiseGate :: update(void)
+{
+  audio_block_t *block;
+  int64_t sum = 0;
+
+  block = receiveWritable();
+  if (!block)
+    return;
+
+  if (bypass)
+  {
+    if (skipSilence && isSilentBlock(block->data, GATE_SILENCE_LEVEL))
+    {
+      release(block);
+      return;
+    }
+    transmit(block);
+    release(block);
+    return;
+  }
+
+  // mean square of this block
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+    sum += block->data[i] * block->data[i];
+
+  float meanSquare = (float)sum / (AUDIO_BLOCK_SAMPLES * 32768.0 * 32768.0);
+
+  // running level, fast rise so the attack isn't missed, ~20ms fall
+  if (meanSquare > level)
+    level = meanSquare;
+  else
+    level += (meanSquare - level) * 0.125;
+
+  // open & close with hysteresis
+  if (level > openThreshold)
+  {
+    gateOpen = true;
+    holdCount = holdBlocks;
+  }
+  else if (level < closeThreshold)
+  {
+    if (holdCount > 0)
+      holdCount--;
+    else
+      gateOpen = false;
+  }
+
+  // new gain for the end of this block, opens in 1 block
+  int32_t startGain = gain;
+  if (gateOpen)
+    gain = GATE_UNITY_GAIN;
+  else
+  {
+    gain -= releaseStep;
+    if (gain < 0)
+      gain = 0;
+  }
+
+  if (startGain == 0 && gain == 0)
+  {
+    // fully closed, send nothing
+    release(block);
+    return;
+  }
+
+  if (startGain != GATE_UNITY_GAIN || gain != GATE_UNITY_GAIN)
+  {
+    // ramp the gain across the block to avoid clicks
+    int32_t g = startGain << 7;
+    int32_t step = gain - startGain;
+
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+    {
+      block->data[i] = (block->data[i] * (g >> 7)) >> 15;
+      g += step;
+    }
+  }
+
+  transmit(block);
+  release(block);
+}
+
+#endif
@@ -0,0 +1,100 @@
+/**************************************************************
+    effect_waveshaper_lut.h - table lookup waveshaper node
+
+    version 1.0   Oct 2026
+
+    Audio library node that passes each sample through a
+    257 entry transfer curve (see shapeCurves.h). The curve
+    is read directly from flash, nothing is copied to RAM,
+    so switching curves is just a pointer change.
+
+    Per sample:
+      x = saturate(sample * drive)
+      y = curve[x >> 8] + (curve[(x >> 8) + 1] - curve[x >> 8]) * (x & 0xFF) / 256
+
+    drive is 8.8 fixed point, 1.0 to 16.0 (0 to 24 dB)
+
+    With no curve set, audio is passed thru unchanged.
+
+ **************************************************************/
+
+#ifndef EFFECT_WAVESHAPER_LUT_H
+#define EFFECT_WAVESHAPER_LUT_H
+
+#include <AudioStream.h>
+#include <dspinst.h>
+
+
+
+// the per-sample work, kept separate so it can be benchmarked
+// without going thru the audio library
+static inline void waveshapeBlock(int16_t *data, const int16_t *curve, int32_t drive)
+{
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+  {
+    // apply drive & clip to 16 bits, then offset to 0 - 65535
+    uint32_t x = signed_saturate_rshift(data[i] * drive, 16, 8) + 32768;
+
+    uint32_t index = x >> 8;
+    int32_t  frac  = x & 0xFF;
+    int32_t  y0    = curve[index];
+    int32_t  y1    = curve[index + 1];
+
+    data[i] = y0 + (((y1 - y0) * frac) >> 8);
+  }
+}
+
+
+
+class AudioEffectWaveshapeLUT : public AudioStream
+{
+  public:
+    AudioEffectWaveshapeLUT() : AudioStream(1, inputQueueArray)
+    {
+      curve = NULL;
+      driveGain = 256;
+    }
+
+    // curve must have 257 entries, NULL for pass thru
+    void shape(const int16_t *table)
+    {
+      __disable_irq();
+      curve = table;
+      __enable_irq();
+    }
+
+    // 1.0 to 16.0
+    void drive(float gain)
+    {
+      gain = constrain(gain, 1.0, 16.0);
+      __disable_irq();
+      driveGain = (int32_t)(gain * 256.0);
+      __enable_irq();
+    }
+
+    virtual void update(void);
+
+  private:
+    audio_block_t *inputQueueArray[1];
+    const int16_t * volatile curve;
+    volatile int32_t driveGain;
+};
+
+
+
+void AudioEffectWaveshapeLUT :: update(void)
+{
+  audio_block_t *block;
+
+  block = receiveWritable();
+  if (!block)
+    return;
+
+  if (curve)
+    waveshapeBlock(block->data, curve, driveGain);
+
+  transmit(block);
+  release(block);
+}
+
+#endif
@@ -0,0 +1,343 @@
+/**************************************************************
+    filter_parametric_eq.h - software parametric EQ node
+
+    version 1.0   Oct 2026
+
+    Audio library node with up to 8 cascaded biquad stages,
+    each with its own frequency, gain and Q. Replaces the
+    SGTL-5000 5 band graphic EQ, which is fixed to 5 bands
+    and can't change the band frequencies.
+
+    The filters run in fixed point using the CMSIS direct
+    form I q31 cascade. The cascade wraps around instead of
+    saturating, so samples are converted from q15 to q31 with
+    enough headroom for the most the bands boost at any
+    frequency, after any stage. That's found from the bands'
+    response whenever one changes: at least PEQ_HEADROOM_BITS,
+    plus a bit spare for the overshoot of a transient. Then
+    it's saturated back to q15, so a big boost clips.
+
+    Bands set to 0 dB are left out of the cascade, so the
+    cost is only paid for the bands that are in use. With
+    no bands in use the audio is passed thru untouched.
+
+    Coefficients are the RBJ audio EQ cookbook peaking and
+    shelving filters. They're calculated in floating point
+    when a band changes, never in the audio interrupt.
+
+ **************************************************************/
+
+#ifndef FILTER_PARAMETRIC_EQ_H
+#define FILTER_PARAMETRIC_EQ_H
+
+#include <AudioStream.h>
+#include <arm_math.h>
+#include <dspinst.h>
+
+
+#define PEQ_MAX_STAGES     8
+
+// coefficients are scaled down by 2^PEQ_POST_SHIFT, range +/- 8.0
+#define PEQ_POST_SHIFT     3
+
+// q15 to q31 headroom, at least 3 bits = 18 dB. 8 bands at
+// +12 dB on the same frequency need 17 (96 dB plus the spare)
+#define PEQ_HEADROOM_BITS  3
+#define PEQ_MAX_HEADROOM   20
+
+// points the response is checked at, log spaced
+#define PEQ_CHECK_POINTS   96
+
+// +/- gain limit, in dB
+#define PEQ_MAX_GAIN       12.0
+
+// band filter types
+#define PEQ_PEAK           0
+#define PEQ_LOW_SHELF      1
+#define PEQ_HIGH_SHELF     2
+
+
+
+// RBJ cookbook biquad, stored in the CMSIS order
+// {b0, b1, b2, -a1, -a2}, normalized to a0 and scaled by 2^-POST_SHIFT
+static void peqCoefficients(int32_t *c, uint8_t type, float freq, float gaindB, float q)
+{
+  freq = constrain(freq, 20.0, AUDIO_SAMPLE_RATE_EXACT * 0.45);
+  q = constrain(q, 0.1, 10.0);
+
+  float A = powf(10.0, gaindB / 40.0);
+  float w0 = 2.0 * PI * freq / AUDIO_SAMPLE_RATE_EXACT;
+  float cosw = cosf(w0);
+  float alpha = sinf(w0) / (2.0 * q);
+  float beta = 2.0 * sqrtf(A) * alpha;
+  float b0, b1, b2, a0, a1, a2;
+
+  switch (type)
+  {
+    case PEQ_LOW_SHELF:
+      b0 = A * ((A + 1.0) - (A - 1.0) * cosw + beta);
+      b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosw);
+      b2 = A * ((A + 1.0) - (A - 1.0) * cosw - beta);
+      a0 = (A + 1.0) + (A - 1.0) * cosw + beta;
+      a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosw);
+      a2 = (A + 1.0) + (A - 1.0) * cosw - beta;
+      break;
+
+    case PEQ_HIGH_SHELF:
+      b0 = A * ((A + 1.0) + (A - 1.0) * cosw + beta);
+      b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosw);
+      b2 = A * ((A + 1.0) + (A - 1.0) * cosw - beta);
+      a0 = (A + 1.0) - (A - 1.0) * cosw + beta;
+      a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosw);
+      a2 = (A + 1.0) - (A - 1.0) * cosw - beta;
+      break;
+
+    default:
+      b0 = 1.0 + alpha * A;
+      b1 = -2.0 * cosw;
+      b2 = 1.0 - alpha * A;
+      a0 = 1.0 + alpha / A;
+      a1 = -2.0 * cosw;
+      a2 = 1.0 - alpha / A;
+      break;
+  }
+
+  float scale = 2147483648.0 / (a0 * (1 << PEQ_POST_SHIFT));
+  c[0] = (int32_t)(b0 * scale);
+  c[1] = (int32_t)(b1 * scale);
+  c[2] = (int32_t)(b2 * scale);
+  c[3] = (int32_t)(-a1 * scale);
+  c[4] = (int32_t)(-a2 * scale);
+}
+
+
+
+// |H|^2 at w radians per sample, for a biquad stored as
+// {b0, b1, b2, -a1, -a2}
+static float peqPower(const float *c, float w)
+{
+  float cw = cosf(w), sw = sinf(w);
+  float c2w = cosf(2.0 * w), s2w = sinf(2.0 * w);
+
+  float nr = c[0] + c[1] * cw + c[2] * c2w;
+  float ni = -c[1] * sw - c[2] * s2w;
+  float dr = 1.0 - c[3] * cw - c[4] * c2w;
+  float di = c[3] * sw + c[4] * s2w;
+  return (nr * nr + ni * ni) / (dr * dr + di * di);
+}
+
+
+
+class AudioFilterParametricEQ : public AudioStream
+{
+  public:
+    AudioFilterParametricEQ() : AudioStream(1, inputQueueArray)
+    {
+      bypass = true;
+      numStages = 0;
+      bandMask = 0;
+      headroom = PEQ_HEADROOM_BITS;
+      for (uint8_t i = 0; i < PEQ_MAX_STAGES; i++)
+      {
+        bandInUse[i] = false;
+        bandFreq[i] = 1000.0;
+      }
+      arm_biquad_cascade_df1_init_q31(&cascade, 0, coefs, state, PEQ_POST_SHIFT);
+    }
+
+    // freq in Hz, gain in dB, q 0.1 to 10
+    void setBand(uint8_t band, uint8_t type, float freq, float gaindB, float q)
+    {
+      if (band >= PEQ_MAX_STAGES)
+        return;
+
+      gaindB = constrain(gaindB, -PEQ_MAX_GAIN, PEQ_MAX_GAIN);
+      bandInUse[band] = fabsf(gaindB) >= 0.1;
+      bandFreq[band] = constrain(freq, 20.0, AUDIO_SAMPLE_RATE_EXACT * 0.45);
+      if (bandInUse[band])
+        peqCoefficients(bandCoefs[band], type, freq, gaindB, q);
+
+      buildCascade();
+    }
+
+    // true = pass audio thru untouched
+    void setBypass(bool state)
+    {
+      bypass = state;
+    }
+
+    // band's coefficients, as set up for the cascade.
+    // false if the band is flat and not being run
+    bool getCoefficients(uint8_t band, int32_t *c)
+    {
+      if (band >= PEQ_MAX_STAGES || !bandInUse[band])
+        return false;
+      for (uint8_t i = 0; i < 5; i++)
+        c[i] = bandCoefs[band][i];
+      return true;
+    }
+
+    // number of biquads being run
+    uint8_t stagesInUse()
+    {
+      return numStages;
+    }
+
+    // bits of q31 headroom for the boost
+    uint8_t headroomBits()
+    {
+      return headroom;
+    }
+
+    virtual void update(void);
+
+  private:
+    void buildCascade();
+    uint8_t neededHeadroom();
+
+    audio_block_t *inputQueueArray[1];
+    volatile bool bypass;
+    bool bandInUse[PEQ_MAX_STAGES];
+    float bandFreq[PEQ_MAX_STAGES];
+    int32_t bandCoefs[PEQ_MAX_STAGES][5];
+
+    // cascade of only the bands in use, used by the interrupt
+    arm_biquad_casd_df1_inst_q31 cascade;
+    volatile uint8_t numStages;
+    volatile uint8_t headroom;
+    uint8_t bandMask;
+    int32_t coefs[PEQ_MAX_STAGES * 5];
+    int32_t state[PEQ_MAX_STAGES * 4];
+};
+
+
+
+// the most the bands boost, after any stage in the order
+// they're run, as bits of headroom with one spare. Checked
+// on a log spaced grid and at each band's frequency, where
+// a narrow peak would fall between the grid points
+uint8_t AudioFilterParametricEQ :: neededHeadroom()
+{
+  const uint8_t numPoints = PEQ_CHECK_POINTS + PEQ_MAX_STAGES;
+  float w[numPoints];
+  float power[numPoints];
+  float peak = 1.0;
+  float c[5];
+
+  for (uint8_t k = 0; k < numPoints; k++)
+  {
+    // 20 Hz to 0.45 fs, the most a band can be set to
+    float f = 20.0 * powf(AUDIO_SAMPLE_RATE_EXACT * 0.45 / 20.0, (float)k / (PEQ_CHECK_POINTS - 1));
+    if (k >= PEQ_CHECK_POINTS)
+      f = bandFreq[k - PEQ_CHECK_POINTS];
+    w[k] = 2.0 * PI * f / AUDIO_SAMPLE_RATE_EXACT;
+    power[k] = 1.0;
+  }
+
+  for (uint8_t i = 0; i < PEQ_MAX_STAGES; i++)
+  {
+    if (!bandInUse[i])
+      continue;
+
+    for (uint8_t j = 0; j < 5; j++)
+      c[j] = bandCoefs[i][j] * ((float)(1 << PEQ_POST_SHIFT) / 2147483648.0);
+
+    for (uint8_t k = 0; k < numPoints; k++)
+    {
+      power[k] *= peqPower(c, w[k]);
+      peak = max(peak, power[k]);
+    }
+  }
+
+  // power is |H|^2, so 4x the power for each bit
+  uint8_t bits = PEQ_HEADROOM_BITS;
+  while (bits < PEQ_MAX_HEADROOM && peak * 4.0 > ldexpf(1.0, 2 * bits))
+    bits++;
+  return bits;
+}
+
+
+
+// pack the bands in use into the cascade. The filter state is
+// only cleared when a band is added or removed, since the stages
+// move around, so turning a knob doesn't click. When the
+// headroom changes the state is shifted to the new scale
+void AudioFilterParametricEQ :: buildCascade()
+{
+  uint8_t n = 0;
+  uint8_t mask = 0;
+  uint8_t bits = neededHeadroom();
+
+  __disable_irq();
+  for (uint8_t i = 0; i < PEQ_MAX_STAGES; i++)
+  {
+    if (bandInUse[i])
+    {
+      for (uint8_t j = 0; j < 5; j++)
+        coefs[n * 5 + j] = bandCoefs[i][j];
+      mask |= 1 << i;
+      n++;
+    }
+  }
+  if (mask != bandMask)
+    arm_biquad_cascade_df1_init_q31(&cascade, n, coefs, state, PEQ_POST_SHIFT);
+  else if (bits > headroom)
+  {
+    for (uint8_t i = 0; i < n * 4; i++)
+      state[i] >>= bits - headroom;
+  }
+  else if (bits < headroom)
+  {
+    int32_t limit = INT32_MAX >> (headroom - bits);
+    for (uint8_t i = 0; i < n * 4; i++)
+      state[i] = constrain(state[i], -limit, limit) << (headroom - bits);
+  }
+  bandMask = mask;
+  numStages = n;
+  headroom = bits;
+  __enable_irq();
+}
+
+
+
+void AudioFilterParametricEQ :: update(void)
+{
+  audio_block_t *block;
+  int32_t data[AUDIO_BLOCK_SAMPLES];
+
+  block = receiveWritable();
+  if (!block)
+    return;
+
+  if (bypass || numStages == 0)
+  {
+    transmit(block);
+    release(block);
+    return;
+  }
+
+  uint8_t bits = headroom;
+
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+    data[i] = ((int32_t)block->data[i] << 16) >> bits;
+
+  arm_biquad_cascade_df1_q31(&cascade, data, data, AUDIO_BLOCK_SAMPLES);
+
+  if (bits <= 16)
+  {
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+      block->data[i] = saturate16(data[i] >> (16 - bits));
+  }
+  else
+  {
+    // the input was shifted down, so the output goes up
+    int32_t limit = 32768 >> (bits - 16);
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+      block->data[i] = saturate16(constrain(data[i], -limit, limit) << (bits - 16));
+  }
+
+  transmit(block);
+  release(block);
+}
+
+#endif
@@ -281,14 +281,20 @@ void splashScreen()
 // show message on the lcd
 void tftMessage(String message)
 {
+  dropout1.activityStart(ACT_SCREEN);
   tft.fillScreen(ILI9341_BLACK);
   tft.drawRect(0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1, ILI9341_RED);
   tft.setTextColor(ILI9341_YELLOW);
   tft.setCursor(80, 60);
   tft.setFont(Arial_16);
   tft.print(message);
-  delay(900);
+  dropout1.activityEnd(ACT_SCREEN);
+
+  idleDelay(900);
+
+  dropout1.activityStart(ACT_SCREEN);
   tft.fillScreen(ILI9341_BLACK);
+  dropout1.activityEnd(ACT_SCREEN);
   msgFlag = false;
 }
 
@@ -49,20 +49,26 @@
 #include <PCF8574.h>
 #include <ILI9341_t3.h>
 #include <XPT2046_Touchscreen.h>
+#include <ADC.h>
 
 #include "guiItems.h"
 
 
 // prototypes
 void checkTeensyType();
+void initPots();
 void resetEncoders();
 long readParamEncoder();
 long readValueEncoder();
 int readMixPot();
 int readWahWahPot();
+int readPedal();
 uint8_t readButtons();
 void setLED(uint8_t led, bool state);
 void blinkLed(uint8_t blinks);
+#ifdef USE_SD_CARD
+bool initSDCard();
+#endif
 
 
 // global vars for encoder & pot status values
@@ -76,6 +82,9 @@ String procType = "UNKNOWN";
 int lastMixPot = 0;
 int lastWahWahPot = 0;
 
+// pots are read by the two ADCs in continuous mode
+ADC *adc = new ADC();
+
 // uncomment to use the SD Card
 //#define USE_SD_CARD
 
@@ -102,19 +111,13 @@ int lastWahWahPot = 0;
 
 
 
-// Use these with the Teensy 3.5/3.6 built-in SD card
+// Use these with the Teensy 3.5/3.6 built-in SD card, it
+// isn't on the SPI bus. TEENSY_3x aren't defined until
+// checkTeensyType(), so test the chips.
 #ifdef USE_SD_CARD
-#ifdef TEENSY_35
-#define SDCARD_CS_PIN    BUILTIN_SDCARD
-#define SDCARD_MOSI_PIN  11
-#define SDCARD_SCK_PIN   13
-#endif
-#ifdef TEENSY_36
+#if defined(__MK64FX512__) || defined(__MK66FX1M0__)
 #define SDCARD_CS_PIN    BUILTIN_SDCARD
-#define SDCARD_MOSI_PIN  11
-#define SDCARD_SCK_PIN   13
-#endif
-#ifdef TEENSY_32
+#else
 // use the sd card on the Teensy Audio Shield
 #define SDCARD_CS_PIN    10
 #define SDCARD_MOSI_PIN  7
@@ -180,6 +183,19 @@ int lastWahWahPot = 0;
 #define TREMOLO_SWITCH  2
 #define WAH_WAH_SWITCH  3
 
+// looper footswitch, a second PCF8574 (USE_LOOPER)
+#define FOOTSWITCH_ADDRESS  0x21
+
+#define LOOP_RECORD_SWITCH  0
+#define LOOP_PLAY_SWITCH    1
+#define LOOP_UNDO_SWITCH    2
+#define LOOP_CLEAR_SWITCH   3
+
+#define LOOP_RECORD_LED     4
+#define LOOP_DUB_LED        5
+#define LOOP_PLAY_LED       6
+#define LOOP_UNDO_LED       7
+
 // future and in-work stuff
 //#define BYPASS_LED    39
 
@@ -280,17 +296,40 @@ long readValueEncoder()
 
 
 
+// each pot gets an ADC converting continuously, with 32
+// hardware averages, so a reading is just a register read.
+// The wah-wah pot (A1) is only on ADC0, the mix pot (A2) is
+// on both. Returns after the first readings are ready.
+void initPots()
+{
+  adc->setResolution(12, ADC_0);
+  adc->setAveraging(32, ADC_0);
+  adc->startContinuous(WAH_WAH_POT, ADC_0);
+
+  adc->setResolution(12, ADC_1);
+  adc->setAveraging(32, ADC_1);
+  adc->startContinuous(MIX_POT, ADC_1);
+
+  // a few hundred us, the timeout is just in case
+  elapsedMillis waitTime;
+  while (!(adc->isComplete(ADC_0) && adc->isComplete(ADC_1)) && waitTime < 10)
+    ;
+}
+
+
+
 // returns 0 to 1023
 int readMixPot()
 {
-  int pot = 0;
+  return (uint16_t)adc->analogReadContinuous(ADC_1) >> 2;
+}
+
 
-  // 8 averages
-  for (uint8_t i = 0; i < 8; i++)
-    pot += analogRead(MIX_POT);
-  pot /= 8;
 
-  return pot;
+// returns 0 to 4095
+int readPedal()
+{
+  return (uint16_t)adc->analogReadContinuous(ADC_0);
 }
 
 
@@ -298,14 +337,7 @@ int readMixPot()
 // returns 0 to 1023
 int readWahWahPot()
 {
-  int pot = 0;
-
-  // read pot & take 8 averages
-  for (uint8_t i = 0; i < 8; i++)
-    pot += analogRead(WAH_WAH_POT);
-  pot /= 8;
-
-  return pot;
+  return readPedal() >> 2;
 }
 
 
@@ -375,4 +407,26 @@ void blinkLED(uint8_t blinks)
 }
 
 
+
+#ifdef USE_SD_CARD
+// the recorder & the library share the card, started once
+bool initSDCard()
+{
+  static bool started = false;
+  static bool present = false;
+
+  if (!started)
+  {
+#ifdef SDCARD_MOSI_PIN
+    SPI.setMOSI(SDCARD_MOSI_PIN);
+    SPI.setSCK(SDCARD_SCK_PIN);
+#endif
+    present = SD.begin(SDCARD_CS_PIN);
+    started = true;
+  }
+  return present;
+}
+#endif
+
+
 #endif
@@ -0,0 +1,543 @@
+/******************************************************
+   library.h - preset library on the SD card
+
+   version 1.0   Oct 2026
+
+   Any number of named presets (up to LIB_MAX_ENTRIES) on
+   the SD card, in two files:
+
+   GEPLIB.IDX - the index, a header then one entry per item
+                with its name, type, size & where it is
+   GEPLIB.DAT - the items, one after the other
+
+   The index is read once at startup and kept in RAM, so
+   browsing never scans the card. Items are read when first
+   needed and kept in a small cache. While browsing, the
+   selected preset & the next one are read ahead, so
+   loading it only copies from RAM & updates the audio.
+   Each load prints how long it took, and how much of that
+   was reading the card.
+
+   The files have their own format version, LIB_VERSION.
+   A preset is the same as an EEPROM preset (presets.h),
+   settings & effects, so one saved by a different
+   EEPROM_VERSION is kept & listed but won't load until it's
+   saved again. An index that can't be read is copied to
+   GEPLIBnn.OLD and a new one started, the data file is
+   never removed, new items go after what's in it.
+
+   Entries have a type so other items, like impulse
+   responses, can be kept in the same files. Only presets
+   exist so far. Names are up to LIB_NAME_LENGTH - 1
+   characters.
+
+   Console: lib            list the library
+            lib save <name>  save the current settings
+            lib load <name>  load a preset
+
+   Screen: touch the center of the status screen. The value
+   encoder moves one preset, the param encoder a page. The
+   selected preset is loaded when it stops for a moment.
+
+   Only built with USE_SD_CARD (hardware.h).
+
+ ******************************************************/
+
+#ifndef LIBRARY_H
+#define LIBRARY_H
+
+#ifdef USE_SD_CARD
+
+
+#define LIB_INDEX_FILE    "GEPLIB.IDX"
+#define LIB_DATA_FILE     "GEPLIB.DAT"
+#define LIB_BACKUP_FILE   "GEPLIB%02u.OLD"
+#define LIB_MAX_BACKUPS   100
+
+// of the index & data files, not the presets in them
+#define LIB_VERSION       1
+
+#define LIB_MAX_ENTRIES   128
+#define LIB_NAME_LENGTH   16
+#define LIB_CACHE_SIZE    4
+
+// entry types
+#define LIB_PRESET        0
+#define LIB_IR            1
+
+// screen
+#define LIB_ROWS          8
+#define LIB_LOAD_MS       300
+
+
+struct LibraryHeader
+{
+  char     magic[4];      // "GEPL"
+  uint16_t version;       // LIB_VERSION
+  uint16_t count;
+};
+
+struct LibraryEntry
+{
+  char     name[LIB_NAME_LENGTH];
+  uint32_t offset;        // in the data file
+  uint16_t size;
+  uint8_t  type;
+  uint8_t  reserved;
+};
+
+
+
+class Library {
+  public:
+    Library();
+    void init();
+    void list();
+    int16_t find(const char *name);
+    bool load(uint16_t n);
+    bool save(const char *name);
+    void process(bool initScreen);
+    void printConfig();
+    uint16_t count;
+
+  private:
+    bool cardPresent;
+    File dataFile;
+    LibraryEntry entries[LIB_MAX_ENTRIES];
+
+    // most recently used presets
+    struct CacheSlot
+    {
+      int16_t entry;
+      uint32_t used;
+      Preset preset;
+    };
+    CacheSlot cache[LIB_CACHE_SIZE];
+    uint32_t useCount;
+
+    // screen
+    int16_t selected;
+    int16_t loaded;
+    bool loadPending;
+    elapsedMillis loadTime;
+
+    const Preset *getPreset(uint16_t n);
+    bool readIndex();
+    bool backupIndex();
+    bool writeIndex();
+    void drawScreen();
+    void drawList();
+    void checkEncoders();
+};
+
+
+
+
+Library :: Library()
+{
+  count = 0;
+  cardPresent = false;
+  useCount = 0;
+  selected = 0;
+  loaded = -1;
+  loadPending = false;
+
+  for (uint8_t i = 0; i < LIB_CACHE_SIZE; i++)
+    cache[i].entry = -1;
+}
+
+
+
+// reads the index, run after the audio board is initialized
+void Library :: init()
+{
+  cardPresent = initSDCard();
+  if (!cardPresent)
+    return;
+
+  // one that can't be read is copied first, the next save
+  // writes a new one
+  if (SD.exists(LIB_INDEX_FILE) && !readIndex())
+  {
+    count = 0;
+    if (!backupIndex())
+    {
+      cardPresent = false;
+      printValue("Can't back up preset library index");
+      return;
+    }
+  }
+
+  // kept open, FILE_WRITE can read too
+  dataFile = SD.open(LIB_DATA_FILE, FILE_WRITE);
+  if (!dataFile)
+  {
+    cardPresent = false;
+    printValue("Can't open preset library");
+    return;
+  }
+
+  printValue("Preset library entries", count);
+}
+
+
+
+// false if it isn't a whole index of this LIB_VERSION
+bool Library :: readIndex()
+{
+  File index = SD.open(LIB_INDEX_FILE, FILE_READ);
+  if (!index)
+    return false;
+
+  LibraryHeader header;
+  bool ok = index.read(&header, sizeof(header)) == sizeof(header) && memcmp(header.magic, "GEPL", 4) == 0;
+  if (ok && header.version != LIB_VERSION)
+  {
+    printValue("Preset library format is version", header.version);
+    ok = false;
+  }
+  if (ok)
+  {
+    count = min(header.count, (uint16_t)LIB_MAX_ENTRIES);
+    ok = index.read(entries, count * sizeof(LibraryEntry)) == (int)(count * sizeof(LibraryEntry));
+  }
+
+  index.close();
+  return ok;
+}
+
+
+
+// copied to the first unused GEPLIBnn.OLD, the SD library
+// can't rename
+bool Library :: backupIndex()
+{
+  char name[16];
+  uint8_t n;
+
+  for (n = 0; n < LIB_MAX_BACKUPS; n++)
+  {
+    sprintf(name, LIB_BACKUP_FILE, n);
+    if (!SD.exists(name))
+      break;
+  }
+  if (n == LIB_MAX_BACKUPS)
+    return false;
+
+  File from = SD.open(LIB_INDEX_FILE, FILE_READ);
+  File to = SD.open(name, FILE_WRITE);
+  bool ok = from && to;
+
+  uint8_t buf[512];
+  while (ok && from.available())
+  {
+    int bytes = from.read(buf, sizeof(buf));
+    ok = bytes > 0 && to.write(buf, bytes) == (size_t)bytes;
+  }
+
+  if (from)
+    from.close();
+  if (to)
+    to.close();
+
+  if (ok)
+  {
+    Serial.print(F("Preset library index can't be used, copied to ")); Serial.println(name);
+  }
+  return ok;
+}
+
+
+
+void Library :: list()
+{
+  if (!cardPresent)
+  {
+    Serial.println(F("No SD card"));
+    return;
+  }
+
+  for (uint16_t i = 0; i < count; i++)
+  {
+    Serial.print(i); Serial.print(": ");
+    Serial.print(entries[i].type == LIB_PRESET ? "preset " : "ir     ");
+    Serial.println(entries[i].name);
+  }
+  Serial.print(count); Serial.println(F(" entries"));
+}
+
+
+
+// -1 if not there
+int16_t Library :: find(const char *name)
+{
+  for (uint16_t i = 0; i < count; i++)
+  {
+    if (strncmp(entries[i].name, name, LIB_NAME_LENGTH) == 0)
+      return i;
+  }
+  return -1;
+}
+
+
+
+// from the cache if it's there, NULL if it isn't a preset,
+// is from another EEPROM_VERSION or can't be read
+const Preset *Library :: getPreset(uint16_t n)
+{
+  if (n >= count || entries[n].type != LIB_PRESET || entries[n].size != sizeof(Preset))
+    return NULL;
+
+  // hit
+  for (uint8_t i = 0; i < LIB_CACHE_SIZE; i++)
+  {
+    if (cache[i].entry == n)
+    {
+      cache[i].used = ++useCount;
+      return &cache[i].preset;
+    }
+  }
+
+  // miss, replace the least recently used
+  uint8_t slot = 0;
+  for (uint8_t i = 1; i < LIB_CACHE_SIZE; i++)
+  {
+    if (cache[i].used < cache[slot].used)
+      slot = i;
+  }
+
+  cache[slot].entry = -1;
+  dropout1.activityStart(ACT_SD);
+  dataFile.seek(entries[n].offset);
+  int bytes = dataFile.read(&cache[slot].preset, sizeof(Preset));
+  dropout1.activityEnd(ACT_SD);
+  if (bytes != sizeof(Preset))
+    return NULL;
+  if (cache[slot].preset.cfg.vers != EEPROM_VERSION)
+    return NULL;
+
+  cache[slot].entry = n;
+  cache[slot].used = ++useCount;
+  return &cache[slot].preset;
+}
+
+
+
+bool Library :: load(uint16_t n)
+{
+  uint32_t t = micros();
+
+  const Preset *p = getPreset(n);
+  if (p == NULL)
+    return false;
+  uint32_t readUs = micros() - t;
+
+  // the effects' debug prints would take most of the time
+  bool debug = debugPrint;
+  debugPrint = false;
+  applyPreset(*p);
+  debugPrint = debug;
+  loaded = n;
+
+  t = micros() - t;
+  Serial.print(F("Loaded ")); Serial.print(entries[n].name);
+  Serial.print(F(" in ")); Serial.print(t);
+  Serial.print(F(" us, read ")); Serial.print(readUs); Serial.println(F(" us"));
+  return true;
+}
+
+
+
+// the current settings, replaces a preset with the same name
+bool Library :: save(const char *name)
+{
+  if (!cardPresent)
+    return false;
+
+  if (strlen(name) >= LIB_NAME_LENGTH)
+  {
+    Serial.print(F("Names are ")); Serial.print(LIB_NAME_LENGTH - 1);
+    Serial.println(F(" characters at most"));
+    return false;
+  }
+
+  int16_t n = find(name);
+  if (n < 0)
+  {
+    if (count == LIB_MAX_ENTRIES)
+      return false;
+
+    n = count;
+    memset(&entries[n], 0, sizeof(LibraryEntry));
+    strcpy(entries[n].name, name);
+    entries[n].offset = dataFile.size();
+    entries[n].size = sizeof(Preset);
+    entries[n].type = LIB_PRESET;
+  }
+  else if (entries[n].type != LIB_PRESET)
+    return false;
+
+  // from a different EEPROM_VERSION with another size, it
+  // goes after the rest instead
+  else if (entries[n].size != sizeof(Preset))
+  {
+    entries[n].offset = dataFile.size();
+    entries[n].size = sizeof(Preset);
+  }
+
+  Preset p;
+  p.cfg = cfg;
+  p.cfg.vers = EEPROM_VERSION;
+  p.effects = effectsMask();
+
+  dropout1.activityStart(ACT_SD);
+  dataFile.seek(entries[n].offset);
+  bool ok = dataFile.write((const uint8_t *)&p, sizeof(Preset)) == sizeof(Preset);
+  dataFile.flush();
+  dropout1.activityEnd(ACT_SD);
+  if (!ok)
+    return false;
+
+  if (n == count)
+    count++;
+
+  // the cached copy is out of date
+  for (uint8_t i = 0; i < LIB_CACHE_SIZE; i++)
+  {
+    if (cache[i].entry == n)
+      cache[i].entry = -1;
+  }
+
+  Serial.print(F("Saved ")); Serial.println(entries[n].name);
+  return writeIndex();
+}
+
+
+
+// the whole index, it's small
+bool Library :: writeIndex()
+{
+  LibraryHeader header;
+  memcpy(header.magic, "GEPL", 4);
+  header.version = LIB_VERSION;
+  header.count = count;
+
+  dropout1.activityStart(ACT_SD);
+  SD.remove(LIB_INDEX_FILE);
+  File index = SD.open(LIB_INDEX_FILE, FILE_WRITE);
+  bool ok = index;
+  ok = ok && index.write((const uint8_t *)&header, sizeof(header)) == sizeof(header);
+  ok = ok && index.write((const uint8_t *)entries, count * sizeof(LibraryEntry)) == count * sizeof(LibraryEntry);
+  if (index)
+    index.close();
+  dropout1.activityEnd(ACT_SD);
+  return ok;
+}
+
+
+
+void Library :: process(bool initScreen)
+{
+  if (initScreen)
+  {
+    drawScreen();
+
+    // don't count an old encoder position as a turn
+    lastParamEncVal = readParamEncoder() / 2;
+    lastValEncVal = readValueEncoder() / 2;
+  }
+
+  checkEncoders();
+
+  // stopped on one for long enough
+  if (loadPending && loadTime > LIB_LOAD_MS)
+  {
+    loadPending = false;
+    if (selected != loaded)
+      load(selected);
+  }
+}
+
+
+
+// value encoder moves one, param encoder a page
+void Library :: checkEncoders()
+{
+  paramEncVal = readParamEncoder() / 2;
+  valEncVal = readValueEncoder() / 2;
+
+  int16_t step = 0;
+  if (paramEncVal != lastParamEncVal)
+    step = (paramEncVal > lastParamEncVal) ? LIB_ROWS : -LIB_ROWS;
+  else if (valEncVal != lastValEncVal)
+    step = (valEncVal > lastValEncVal) ? 1 : -1;
+
+  lastParamEncVal = paramEncVal;
+  lastValEncVal = valEncVal;
+
+  if (step == 0 || count == 0)
+    return;
+
+  selected = constrain(selected + step, 0, count - 1);
+  drawList();
+
+  // read ahead, so the load is from RAM
+  getPreset(selected);
+  if (selected + step >= 0 && selected + step < count)
+    getPreset(selected + step);
+
+  loadPending = true;
+  loadTime = 0;
+}
+
+
+
+void Library :: drawScreen()
+{
+  eraseScreen();
+  drawTitle("Presets");
+  drawList();
+}
+
+
+
+// the page with the selected preset
+void Library :: drawList()
+{
+  tft.setFont(Arial_14);
+
+  if (count == 0)
+  {
+    drawLabel(20, 100, cardPresent ? "No presets, use lib save" : "No SD card", false);
+    return;
+  }
+
+  int16_t first = selected - selected % LIB_ROWS;
+  for (uint8_t row = 0; row < LIB_ROWS; row++)
+  {
+    int16_t y = 20 + row * 24;
+    int16_t n = first + row;
+
+    tft.fillRect(10, y - 2, 300, 22, GUI_FILL_COLOR);
+    if (n < count)
+      drawLabel(20, y, String(n) + "  " + entries[n].name, n == selected);
+  }
+}
+
+
+
+void Library :: printConfig()
+{
+  Serial.print("Library Entries = "); Serial.println(count);
+  Serial.print("Library Loaded  = ");
+  if (loaded >= 0)
+    Serial.println(entries[loaded].name);
+  else
+    Serial.println("-");
+}
+
+
+Library library;
+
+#endif
+#endif
@@ -0,0 +1,234 @@
+/******************************************************
+   memprofile.h - audio memory use by effects combination
+
+   version 1.0   Oct 2026
+
+   Keeps the most audio memory blocks used with each
+   combination of effects, tuner, analyzer FFTs, recorder
+   queues & looper seen this session, and the session peak.
+
+   Whatever changes one of those calls memProfileSample()
+   (Teensy_GEP.ino) first, so the peak up to then goes to
+   the old combination and the max is reset for the new
+   one. A change that isn't sampled is still seen by poll(),
+   but the peak since the last poll goes to the old one.
+
+   The 'A' serial command prints the table and the smallest
+   safe pool, the session peak plus a margin. Build with
+   AUDIO_MEMORY_BLOCKS (Teensy_GEP.ino) set to that, after
+   playing with every combination that will be used. Each
+   block is 260 bytes of RAM, which can go to longer
+   flanger & chorus delay lines.
+
+   The pool has to cover the peak of everything that runs
+   at once, so the combination with the highest peak sets
+   the size, not the one used most.
+
+ ******************************************************/
+
+#ifndef MEM_PROFILE_H
+#define MEM_PROFILE_H
+
+
+#define MEM_PROFILE_SIZE    32
+#define MEM_PROFILE_MS      250
+
+// added to the session peak for the safe size
+#define MEM_PROFILE_MARGIN  8
+
+// beyond the effects in effectsMask(), other things that
+// use blocks
+#define LOOPER_BIT          11    // recording or playing
+#define REC_DRY_BIT         12    // second record queue
+#define REC_BIT             13    // record queue, up to 53 blocks
+#define ANALYZER_BIT        14    // FFTs connected
+#define TUNER_BIT           15
+
+
+
+class MemProfile {
+  public:
+    MemProfile();
+    void poll();
+    void sample();
+    void report();
+    uint16_t safeBlocks();
+
+  private:
+    struct Entry
+    {
+      uint16_t mask;
+      uint16_t maxBlocks;
+      uint32_t ms;
+    };
+
+    Entry entries[MEM_PROFILE_SIZE];
+    uint8_t numEntries;
+    int8_t current;
+    uint16_t lastMask;
+    bool started;
+    bool sampled;
+    uint16_t sessionMax;
+    uint16_t overflows;
+    elapsedMillis pollTime;
+
+    uint16_t currentMask();
+    void credit();
+    int8_t findEntry(uint16_t mask);
+};
+
+
+
+MemProfile :: MemProfile()
+{
+  numEntries = 0;
+  current = -1;
+  lastMask = 0;
+  started = false;
+  sampled = false;
+  sessionMax = 0;
+  overflows = 0;
+}
+
+
+
+// called while the main loop waits
+void MemProfile :: poll()
+{
+  uint16_t mask = currentMask();
+
+  // changed without a sample, what's been used is counted
+  // as the old combination's
+  if (started && mask != lastMask && !sampled)
+    credit();
+
+  // new combination, its peak is from the last sample
+  if (!started || mask != lastMask)
+  {
+    current = findEntry(mask);
+    lastMask = mask;
+    started = true;
+  }
+  sampled = false;
+
+  if (pollTime >= MEM_PROFILE_MS)
+    credit();
+}
+
+
+
+// call just before a change, the peak so far goes to the
+// combination that's ending
+void MemProfile :: sample()
+{
+  credit();
+  sampled = true;
+}
+
+
+
+// the peak since the last one to the current combination,
+// then start a new one
+void MemProfile :: credit()
+{
+  uint32_t ms = pollTime;
+  pollTime = 0;
+
+  uint16_t used = (uint16_t)AudioMemoryUsageMax();
+  AudioMemoryUsageMaxReset();
+  sessionMax = max(sessionMax, used);
+
+  if (current >= 0)
+  {
+    entries[current].maxBlocks = max(entries[current].maxBlocks, used);
+    entries[current].ms += ms;
+  }
+}
+
+
+
+uint16_t MemProfile :: currentMask()
+{
+  uint16_t mask = effectsMask();
+
+  mask |= tuner.active << TUNER_BIT;
+  mask |= analyzer.isOpen() << ANALYZER_BIT;
+#ifdef USE_SD_CARD
+  mask |= recorder.recording << REC_BIT;
+  mask |= recorder.recordingDry() << REC_DRY_BIT;
+#endif
+#ifdef USE_LOOPER
+  uint8_t state = looper1.state();
+  mask |= (state != LOOP_EMPTY && state != LOOP_STOPPED) << LOOPER_BIT;
+#endif
+  return mask;
+}
+
+
+
+// adds it if it's new, -1 when the table is full
+int8_t MemProfile :: findEntry(uint16_t mask)
+{
+  for (uint8_t i = 0; i < numEntries; i++)
+  {
+    if (entries[i].mask == mask)
+      return i;
+  }
+
+  if (numEntries == MEM_PROFILE_SIZE)
+  {
+    overflows++;
+    return -1;
+  }
+
+  entries[numEntries].mask = mask;
+  entries[numEntries].maxBlocks = 0;
+  entries[numEntries].ms = 0;
+  return numEntries++;
+}
+
+
+
+uint16_t MemProfile :: safeBlocks()
+{
+  return sessionMax + MEM_PROFILE_MARGIN;
+}
+
+
+
+// effects by their serial command letters, then l looper,
+// d recording dry, r recording, a analyzer, u tuner
+void MemProfile :: report()
+{
+  const char others[] = "ldrau";
+
+  Serial.println(F("Audio memory by effects (C E R D T F W c S G l d r a u)"));
+  for (uint8_t i = 0; i < numEntries; i++)
+  {
+    printEffects(entries[i].mask);
+    for (uint8_t b = LOOPER_BIT; b <= TUNER_BIT; b++)
+      Serial.print((entries[i].mask >> b) & 1 ? others[b - LOOPER_BIT] : '-');
+
+    Serial.print(F("  max ")); Serial.print(entries[i].maxBlocks);
+    Serial.print(F("  secs ")); Serial.println(entries[i].ms / 1000);
+  }
+  if (overflows)
+  {
+    Serial.print(overflows); Serial.println(F(" combinations not listed, table full"));
+  }
+
+  Serial.print(F("Session peak    = ")); Serial.println(sessionMax);
+  Serial.print(F("Pool size       = ")); Serial.println(AUDIO_MEMORY_BLOCKS);
+  Serial.print(F("Safe pool size  = ")); Serial.println(safeBlocks());
+  if (safeBlocks() < AUDIO_MEMORY_BLOCKS)
+  {
+    Serial.print(F("#define AUDIO_MEMORY_BLOCKS ")); Serial.print(safeBlocks());
+    Serial.print(F(" frees ")); Serial.print((AUDIO_MEMORY_BLOCKS - safeBlocks()) * sizeof(audio_block_t));
+    Serial.println(F(" bytes"));
+  }
+  else if (safeBlocks() > AUDIO_MEMORY_BLOCKS)
+    Serial.println(F("Pool is too small, increase AUDIO_MEMORY_BLOCKS"));
+  Serial.println();
+}
+
+#endif
@@ -0,0 +1,202 @@
+/******************************************************
+   midi.h - USB MIDI control of effects & presets
+
+   version 1.0   Oct 2026
+
+   Enabled with USE_USB_MIDI, which needs USB Type set to
+   'Serial + MIDI' in the Tools menu.
+
+   Program change 0 to NUM_PRESETS - 1 recalls a preset
+   (presets.h). Control changes set params from the
+   registry (params.h), 0 - 127 scaled to the param's range:
+
+     CC 11  expression     wah-wah position
+     CC 12  effect ctrl 1  delay mix (both taps)
+     CC 91  reverb send    reverb volume
+     CC 93  chorus send    chorus volume
+
+   Any channel is accepted. The usbMIDI callbacks only put
+   events in a small queue, it's emptied once per loop,
+   where repeated CCs for the same param just replace the
+   value & each effect is updated once. A burst of CCs from
+   a pedal sweep costs one update, not one per message.
+
+ ******************************************************/
+
+#ifndef MIDI_H
+#define MIDI_H
+
+#ifdef USE_USB_MIDI
+
+#ifndef USB_MIDI_SERIAL
+#error "USE_USB_MIDI needs USB Type 'Serial + MIDI'"
+#endif
+
+
+// power of 2
+#define MIDI_QUEUE_SIZE   32
+
+#define MIDI_CC_WAHWAH    11
+
+
+struct MidiEvent
+{
+  uint8_t type;
+  uint8_t number;
+  uint8_t value;
+};
+
+
+struct MidiMap
+{
+  uint8_t cc;
+  const char *param;
+};
+
+const MidiMap midiMap[] =
+{
+  {12, "delay.volume[0]"},
+  {12, "delay.volume[1]"},
+  {91, "reverb.volume"},
+  {93, "chorus.volume"}
+};
+
+#define NUM_MIDI_MAPS (sizeof(midiMap) / sizeof(midiMap[0]))
+
+
+
+class Midi {
+  public:
+    void init();
+    void poll();
+    void process();
+    void push(uint8_t type, uint8_t number, uint8_t value);
+
+  private:
+    // single producer (the callbacks) single consumer (process)
+    MidiEvent queue[MIDI_QUEUE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile uint16_t dropped;
+    uint16_t reported;
+
+    int16_t mapIds[NUM_MIDI_MAPS];
+};
+
+Midi midi;
+
+
+
+void midiControlChange(uint8_t channel, uint8_t control, uint8_t value)
+{
+  midi.push(usbMIDI.ControlChange, control, value);
+}
+
+
+
+void midiProgramChange(uint8_t channel, uint8_t program)
+{
+  midi.push(usbMIDI.ProgramChange, program, 0);
+}
+
+
+
+void Midi :: init()
+{
+  head = 0;
+  tail = 0;
+  dropped = 0;
+  reported = 0;
+
+  for (uint8_t i = 0; i < NUM_MIDI_MAPS; i++)
+    mapIds[i] = findParam(midiMap[i].param);
+
+  usbMIDI.setHandleControlChange(midiControlChange);
+  usbMIDI.setHandleProgramChange(midiProgramChange);
+}
+
+
+
+// take in the waiting messages, called while the loop waits
+void Midi :: poll()
+{
+  while (usbMIDI.read())
+    ;
+}
+
+
+
+// dropped when full, the newest CCs will follow anyway
+void Midi :: push(uint8_t type, uint8_t number, uint8_t value)
+{
+  uint8_t h = head;
+  uint8_t next = (h + 1) & (MIDI_QUEUE_SIZE - 1);
+
+  if (next == tail)
+  {
+    dropped++;
+    return;
+  }
+  queue[h] = {type, number, value};
+  head = next;
+}
+
+
+
+// once per loop, apply everything that's queued
+void Midi :: process()
+{
+  int16_t wahValue = -1;
+  uint8_t ids[NUM_MIDI_MAPS];
+  uint8_t numIds = 0;
+
+  while (tail != head)
+  {
+    MidiEvent e = queue[tail];
+    tail = (tail + 1) & (MIDI_QUEUE_SIZE - 1);
+
+    // a preset replaces all the settings, including any
+    // CCs before it
+    if (e.type == usbMIDI.ProgramChange)
+    {
+      loadPreset(e.number);
+      numIds = 0;
+      continue;
+    }
+
+    if (e.number == MIDI_CC_WAHWAH)
+      wahValue = e.value;
+
+    for (uint8_t i = 0; i < NUM_MIDI_MAPS; i++)
+    {
+      if (midiMap[i].cc != e.number || mapIds[i] < 0)
+        continue;
+
+      const Param &p = params[mapIds[i]];
+      setParam(mapIds[i], p.minVal + e.value * (p.maxVal - p.minVal) / 127.0, false);
+
+      bool listed = false;
+      for (uint8_t j = 0; j < numIds; j++)
+        listed |= ids[j] == mapIds[i];
+      if (!listed)
+        ids[numIds++] = mapIds[i];
+    }
+  }
+
+  if (numIds)
+    applyParams(ids, numIds);
+
+  // straight to the effect so the pot only takes over when
+  // it's moved
+  if (wahValue >= 0)
+    wahwah.update(wahValue * 1023 / 127);
+
+  if (dropped != reported)
+  {
+    printValue("MIDI events dropped", dropped - reported);
+    reported = dropped;
+  }
+}
+
+#endif
+#endif
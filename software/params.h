@@ -0,0 +1,360 @@
+/******************************************************
+   params.h - registry of the settings that can be read
+   and changed remotely
+
+   version 1.0   Oct 2026
+
+   Every adjustable setting in cfg (and each effect's on/off)
+   has an entry with its name, type, range and the function
+   that applies it to the audio nodes. The entry's position
+   in the table is its id in the binary serial protocol
+   (protocol.h).
+
+   Names are  effect.setting  with [n] for arrays, e.g.
+   "reverb.roomsize", "delay.time[1]".
+
+   Values are passed as floats and constrained to the range.
+   A batch of changes can be set without applying, then
+   applyParams() runs each apply function once. The screen
+   is only redrawn when it shows one of the changed params.
+
+ ******************************************************/
+
+#ifndef PARAMS_H
+#define PARAMS_H
+
+
+// types of the values pointed to
+#define PARAM_FLOAT   0
+#define PARAM_UINT8   1
+#define PARAM_INT16   2
+#define PARAM_BOOL    3
+
+// most params that can be changed in one batch
+#define MAX_PARAM_BATCH 64
+
+
+// redraws the current screen with the new values
+extern boolean initScreen;
+extern uint8_t menuIndex;
+
+
+struct Param
+{
+  const char *name;
+  uint8_t type;
+  void *value;
+  float minVal;
+  float maxVal;
+  void (*apply)();
+};
+
+// the screen that shows the params starting with prefix
+struct ParamScreen
+{
+  const char *prefix;
+  uint8_t screen;
+};
+
+
+// prototypes
+int16_t findParam(const char *name);
+int8_t paramScreen(uint8_t id);
+float getParam(uint8_t id);
+bool setParam(uint8_t id, float value, bool apply = true);
+void applyParams(const uint8_t *ids, uint8_t count);
+
+
+
+// apply functions, the effect's update() reads the new
+// value from cfg, enable() / disable() follow the flag
+template <class T, T &effect> void applyUpdate()
+{
+  effect.update();
+}
+
+template <class T, T &effect> void applyEnabled()
+{
+  memProfileSample();
+  if (effect.enabled)
+    effect.enable();
+  else
+    effect.disable();
+  updateLEDs();
+}
+
+// the tuner's update() collects readings, so it has its own
+void applyTuner()
+{
+  tuner.applySettings();
+}
+
+
+
+// a parametric EQ band's freq, gain and q. The table has one
+// line per band, so there must be as many as NUM_PEQ_BANDS
+#define PEQ_BAND_PARAMS(n) \
+  {"eq.freq[" #n "]", PARAM_FLOAT, &cfg.peqFreq[n], 20,   20000, applyUpdate<EQ, eq>}, \
+  {"eq.gain[" #n "]", PARAM_FLOAT, &cfg.peqGain[n], -PEQ_MAX_GAIN, PEQ_MAX_GAIN, applyUpdate<EQ, eq>}, \
+  {"eq.q[" #n "]",    PARAM_FLOAT, &cfg.peqQ[n],    0.3,  10,    applyUpdate<EQ, eq>},
+
+#ifdef USE_SOFTWARE_EQ
+static_assert(NUM_PEQ_BANDS == 8, "add or remove PEQ_BAND_PARAMS() lines to match NUM_PEQ_BANDS");
+#endif
+
+
+
+const Param params[] =
+{
+  // on / off
+  {"comp.enabled",     PARAM_BOOL,  &compressor.enabled,  0,     1,     applyEnabled<Compressor, compressor>},
+  {"eq.enabled",       PARAM_BOOL,  &eq.enabled,          0,     1,     applyEnabled<EQ, eq>},
+  {"reverb.enabled",   PARAM_BOOL,  &reverb.enabled,      0,     1,     applyEnabled<Reverb, reverb>},
+  {"delay.enabled",    PARAM_BOOL,  &delayer.enabled,     0,     1,     applyEnabled<Delayer, delayer>},
+  {"tremolo.enabled",  PARAM_BOOL,  &tremolo.enabled,     0,     1,     applyEnabled<Tremolo, tremolo>},
+  {"flanger.enabled",  PARAM_BOOL,  &flanger.enabled,     0,     1,     applyEnabled<Flanger, flanger>},
+  {"wahwah.enabled",   PARAM_BOOL,  &wahwah.enabled,      0,     1,     applyEnabled<WahWah, wahwah>},
+  {"chorus.enabled",   PARAM_BOOL,  &chorus.enabled,      0,     1,     applyEnabled<Chorus, chorus>},
+  {"shaper.enabled",   PARAM_BOOL,  &waveshaper.enabled,  0,     1,     applyEnabled<Waveshaper, waveshaper>},
+  {"gate.enabled",     PARAM_BOOL,  &noiseGate.enabled,   0,     1,     applyEnabled<NoiseGate, noiseGate>},
+
+  // compressor
+#ifdef USE_SOFTWARE_COMPRESSOR
+  {"comp.threshold",   PARAM_FLOAT, &cfg.compThreshold,   -96,   0,     applyUpdate<Compressor, compressor>},
+  {"comp.ratio",       PARAM_FLOAT, &cfg.compRatio,       1,     100,   applyUpdate<Compressor, compressor>},
+  {"comp.knee",        PARAM_FLOAT, &cfg.compKnee,        0,     24,    applyUpdate<Compressor, compressor>},
+  {"comp.attack",      PARAM_FLOAT, &cfg.compAttackTime,  0.1,   50,    applyUpdate<Compressor, compressor>},
+  {"comp.release",     PARAM_FLOAT, &cfg.compReleaseTime, 10,    1000,  applyUpdate<Compressor, compressor>},
+  {"comp.gain",        PARAM_UINT8, &cfg.compGain,        0,     2,     applyUpdate<Compressor, compressor>},
+  {"comp.lookahead",   PARAM_BOOL,  &cfg.compLookahead,   0,     1,     applyUpdate<Compressor, compressor>},
+#else
+  {"comp.threshold",   PARAM_FLOAT, &cfg.compThreshold,   -96,   0,     applyUpdate<Compressor, compressor>},
+  {"comp.attack",      PARAM_FLOAT, &cfg.compAttack,      0,     100,   applyUpdate<Compressor, compressor>},
+  {"comp.decay",       PARAM_FLOAT, &cfg.compDecay,       0,     100,   applyUpdate<Compressor, compressor>},
+  {"comp.gain",        PARAM_UINT8, &cfg.compGain,        0,     2,     applyUpdate<Compressor, compressor>},
+  {"comp.response",    PARAM_UINT8, &cfg.compResponse,    0,     3,     applyUpdate<Compressor, compressor>},
+#endif
+
+  // equalizer
+#ifdef USE_SOFTWARE_EQ
+  PEQ_BAND_PARAMS(0)
+  PEQ_BAND_PARAMS(1)
+  PEQ_BAND_PARAMS(2)
+  PEQ_BAND_PARAMS(3)
+  PEQ_BAND_PARAMS(4)
+  PEQ_BAND_PARAMS(5)
+  PEQ_BAND_PARAMS(6)
+  PEQ_BAND_PARAMS(7)
+#else
+  {"eq.band[0]",      PARAM_FLOAT, &cfg.eqBandVals[0],   -1.0,  1.0,   applyUpdate<EQ, eq>},
+  {"eq.band[1]",      PARAM_FLOAT, &cfg.eqBandVals[1],   -1.0,  1.0,   applyUpdate<EQ, eq>},
+  {"eq.band[2]",      PARAM_FLOAT, &cfg.eqBandVals[2],   -1.0,  1.0,   applyUpdate<EQ, eq>},
+  {"eq.band[3]",      PARAM_FLOAT, &cfg.eqBandVals[3],   -1.0,  1.0,   applyUpdate<EQ, eq>},
+  {"eq.band[4]",      PARAM_FLOAT, &cfg.eqBandVals[4],   -1.0,  1.0,   applyUpdate<EQ, eq>},
+#endif
+
+  // tremolo
+  {"tremolo.volume",   PARAM_FLOAT, &cfg.tremoloVolume,   0,     1.0,   applyUpdate<Tremolo, tremolo>},
+  {"tremolo.speed",    PARAM_FLOAT, &cfg.tremoloSpeed,    0,     8.0,   applyUpdate<Tremolo, tremolo>},
+  {"tremolo.depth",    PARAM_FLOAT, &cfg.tremoloDepth,    0,     1.0,   applyUpdate<Tremolo, tremolo>},
+
+  // reverb
+  {"reverb.volume",    PARAM_FLOAT, &cfg.reverbVolume,    0,     1.0,   applyUpdate<Reverb, reverb>},
+  {"reverb.roomsize",  PARAM_FLOAT, &cfg.reverbRoomsize,  0,     1.0,   applyUpdate<Reverb, reverb>},
+  {"reverb.damping",   PARAM_FLOAT, &cfg.reverbDamping,   0,     1.0,   applyUpdate<Reverb, reverb>},
+
+  // delay
+  {"delay.time[0]",    PARAM_FLOAT, &cfg.delayTimes[0],   0,     DELAY_MAX_MS,  applyUpdate<Delayer, delayer>},
+  {"delay.time[1]",    PARAM_FLOAT, &cfg.delayTimes[1],   0,     DELAY_MAX_MS,  applyUpdate<Delayer, delayer>},
+  {"delay.volume[0]",  PARAM_FLOAT, &cfg.delayVols[0],    0,     1.0,   applyUpdate<Delayer, delayer>},
+  {"delay.volume[1]",  PARAM_FLOAT, &cfg.delayVols[1],    0,     1.0,   applyUpdate<Delayer, delayer>},
+  {"delay.recirculate", PARAM_FLOAT, &cfg.recirculate,    0,     1.0,   applyUpdate<Delayer, delayer>},
+
+  // flanger
+  {"flanger.speed",    PARAM_FLOAT, &cfg.flangerSpeed,    0.15,  4,     applyUpdate<Flanger, flanger>},
+  {"flanger.depth",    PARAM_INT16, &cfg.flangerDepth,    48,    48 + 2 * AUDIO_BLOCK_SAMPLES, applyUpdate<Flanger, flanger>},
+
+  // chorus
+  {"chorus.voices",    PARAM_FLOAT, &cfg.chorusVoices,    0,     5,     applyUpdate<Chorus, chorus>},
+  {"chorus.volume",    PARAM_FLOAT, &cfg.chorusVolume,    0,     1.0,   applyUpdate<Chorus, chorus>},
+
+  // waveshaper
+  {"shaper.curve",     PARAM_UINT8, &cfg.shapeCurve,      0,     NUM_SHAPE_CURVES - 1, applyUpdate<Waveshaper, waveshaper>},
+  {"shaper.drive",     PARAM_FLOAT, &cfg.shapeDrive,      1.0,   16.0,  applyUpdate<Waveshaper, waveshaper>},
+  {"shaper.volume",    PARAM_FLOAT, &cfg.shapeVolume,     0,     1.0,   applyUpdate<Waveshaper, waveshaper>},
+
+  // noise gate
+  {"gate.threshold",   PARAM_FLOAT, &cfg.gateThreshold,   -96,   0,     applyUpdate<NoiseGate, noiseGate>},
+  {"gate.hysteresis",  PARAM_FLOAT, &cfg.gateHysteresis,  0,     24,    applyUpdate<NoiseGate, noiseGate>},
+  {"gate.hold",        PARAM_FLOAT, &cfg.gateHold,        0,     1000,  applyUpdate<NoiseGate, noiseGate>},
+  {"gate.release",     PARAM_FLOAT, &cfg.gateRelease,     1,     1000,  applyUpdate<NoiseGate, noiseGate>},
+
+  // input
+  {"input.level",      PARAM_UINT8, &cfg.inputLevel,      0,     15,    applyUpdate<Levels, levels>},
+
+  // wah-wah pedal, used on the next reading
+  {"pedal.heel",       PARAM_INT16, &cfg.pedalHeel,       0,     4095,  NULL},
+  {"pedal.toe",        PARAM_INT16, &cfg.pedalToe,        0,     4095,  NULL},
+  {"pedal.curve",      PARAM_UINT8, &cfg.pedalCurve,      0,     NUM_PEDAL_CURVES - 1, NULL},
+
+#ifdef USE_LOOPER
+  {"looper.enabled",   PARAM_BOOL,  &looper.enabled,      0,     1,     applyEnabled<Looper, looper>},
+  {"looper.volume",    PARAM_FLOAT, &cfg.looperVolume,    0,     1.0,   applyUpdate<Looper, looper>},
+#endif
+
+#ifdef AUDIO_INTERFACE
+  // usb audio, not saved
+  {"usb.dry",          PARAM_BOOL,  &usbAudio.dry,        0,     1,     applyUpdate<UsbAudio, usbAudio>},
+  {"usb.reamp",        PARAM_BOOL,  &usbAudio.reamp,      0,     1,     applyUpdate<UsbAudio, usbAudio>},
+#endif
+
+#ifdef USE_SD_CARD
+  // sd card recorder, used next time it starts, not saved
+  {"rec.dry",          PARAM_BOOL,  &recorder.dry,        0,     1,     NULL},
+#endif
+
+  // tuner, applied now if it's open
+  {"tuner.ref",        PARAM_FLOAT, &cfg.tunerRef,        TUNER_REF_MIN, TUNER_REF_MAX, applyTuner},
+  {"tuner.tuning",     PARAM_UINT8, &cfg.tuning,          0,     NUM_TUNINGS - 1, applyTuner},
+  {"tuner.view",       PARAM_UINT8, &cfg.tunerView,       0,     NUM_TUNER_VIEWS - 1, applyTuner},
+  {"tuner.mute",       PARAM_BOOL,  &cfg.tunerMute,       0,     1,     applyTuner}
+};
+
+#define NUM_PARAMS (sizeof(params) / sizeof(params[0]))
+
+
+// on / off is on the status screen, gate, pedal, looper,
+// usb & recorder params aren't shown
+const ParamScreen paramScreens[] =
+{
+  {"comp.",     COMPRESSOR_SCREEN},
+  {"eq.",       EQ_SCREEN},
+  {"tremolo.",  TREMOLO_SCREEN},
+  {"reverb.",   REVERB_SCREEN},
+  {"delay.",    DELAY_SCREEN},
+  {"flanger.",  FLANGER_SCREEN},
+  {"chorus.",   CHORUS_SCREEN},
+  {"shaper.",   SHAPER_SCREEN},
+  {"input.",    INPUT_SCREEN},
+  {"tuner.",    TUNER_SCREEN}
+};
+
+#define NUM_PARAM_SCREENS (sizeof(paramScreens) / sizeof(paramScreens[0]))
+
+
+
+// id of a param by name, -1 if not found
+int16_t findParam(const char *name)
+{
+  for (uint16_t i = 0; i < NUM_PARAMS; i++)
+  {
+    if (strcmp(params[i].name, name) == 0)
+      return i;
+  }
+  return -1;
+}
+
+
+
+float getParam(uint8_t id)
+{
+  if (id >= NUM_PARAMS)
+    return 0;
+
+  const Param &p = params[id];
+  switch (p.type)
+  {
+    case PARAM_UINT8:
+      return *(uint8_t *)p.value;
+    case PARAM_INT16:
+      return *(int16_t *)p.value;
+    case PARAM_BOOL:
+      return *(bool *)p.value ? 1.0 : 0;
+    default:
+      return *(float *)p.value;
+  }
+}
+
+
+
+// -1 if it isn't on any screen
+int8_t paramScreen(uint8_t id)
+{
+  if (id >= NUM_PARAMS)
+    return -1;
+
+  const char *name = params[id].name;
+  if (strstr(name, ".enabled"))
+    return STATUS_SCREEN;
+
+  for (uint8_t i = 0; i < NUM_PARAM_SCREENS; i++)
+  {
+    if (strncmp(name, paramScreens[i].prefix, strlen(paramScreens[i].prefix)) == 0)
+      return paramScreens[i].screen;
+  }
+  return -1;
+}
+
+
+
+// constrain & store the value, apply it now unless batching
+bool setParam(uint8_t id, float value, bool apply)
+{
+  if (id >= NUM_PARAMS || isnan(value))
+    return false;
+
+  const Param &p = params[id];
+  value = constrain(value, p.minVal, p.maxVal);
+
+  switch (p.type)
+  {
+    case PARAM_UINT8:
+      *(uint8_t *)p.value = (uint8_t)roundf(value);
+      break;
+    case PARAM_INT16:
+      *(int16_t *)p.value = (int16_t)roundf(value);
+      break;
+    case PARAM_BOOL:
+      *(bool *)p.value = value >= 0.5;
+      break;
+    default:
+      *(float *)p.value = value;
+  }
+
+  if (apply)
+    applyParams(&id, 1);
+  return true;
+}
+
+
+
+// runs each different apply function once for a batch of
+// params, then redraws the screen if it shows one of them
+void applyParams(const uint8_t *ids, uint8_t count)
+{
+  void (*applied[MAX_PARAM_BATCH])();
+  uint8_t numApplied = 0;
+  bool redraw = false;
+
+  for (uint8_t i = 0; i < count && numApplied < MAX_PARAM_BATCH; i++)
+  {
+    redraw |= paramScreen(ids[i]) == menuIndex;
+
+    if (ids[i] >= NUM_PARAMS || !params[ids[i]].apply)
+      continue;
+
+    bool done = false;
+    for (uint8_t j = 0; j < numApplied; j++)
+      done |= applied[j] == params[ids[i]].apply;
+    if (done)
+      continue;
+
+    params[ids[i]].apply();
+    applied[numApplied++] = params[ids[i]].apply;
+  }
+
+  if (redraw)
+    initScreen = true;
+}
+
+#endif
@@ -22,61 +22,104 @@
 #include <SD.h>
 #include <SerialFlash.h>
 
+// custom audio nodes
+#include "effect_waveshaper_lut.h"
+#include "effect_noise_gate.h"
+#include "effect_compressor.h"
+#include "filter_parametric_eq.h"
+#include "analyze_loudness.h"
+#include "analyze_clip.h"
+#include "analyze_pitch.h"
+#include "analyze_strum.h"
+#include "effect_looper.h"
+#include "analyze_dropout.h"
+
+// created first so it's updated first, times every update
+AudioAnalyzeDropout      dropout1(AUDIO_MEMORY_BLOCKS);
+
 // GUItool: begin automatically generated code
 AudioSynthWaveformSine   sine1;          //xy=59.5,385
 AudioSynthWaveformDc     dc1;            //xy=60.5,445
 AudioSynthWaveformDc     dc2;            //xy=63.5,316
 AudioSynthWaveformSine   sine2;          //xy=75.5,188
 AudioInputI2S            i2s1;           //xy=76.5,140
+AudioEffectNoiseGate     gate1;          //xy=150.5,140
+AudioEffectCompressor    comp1;          //xy=150.5,190
 AudioMixer4              mixer1;         //xy=227.5,193
 AudioMixer4              mixer2;         //xy=262.5,442
 AudioMixer4              mixer5;         //xy=322,525
 AudioAnalyzePeak         peak1;          //xy=415.5,107
-AudioAnalyzeNoteFrequency notefreq1;      //xy=417.5,57
+AudioAnalyzeFFT256       fft256_1;       //xy=417.5,17
+AudioAnalyzeLoudness     loud1;          //xy=417.5,157
+AudioAnalyzePitch        pitch1;         //xy=417.5,57
+AudioAnalyzeStrum        strum1;         //xy=417.5,77
 AudioEffectChorus        chorus1;        //xy=477.5,286
 AudioEffectFreeverb      freeverb1;      //xy=479.5,233
-AudioEffectDelayExternal delayExt1;      //xy=478.5,526
+AudioEffectDelayExternal delayExt1(AUDIO_MEMORY_23LC1024, SRAM_DELAY_SAMPLES); //xy=478.5,526
 AudioFilterStateVariable filter1;        //xy=479.5,340
 AudioEffectFlange        flange1;        //xy=480.5,392
 AudioEffectMultiply      multiply1;      //xy=481.5,439
+AudioEffectWaveshapeLUT  shape1;         //xy=481.5,488
 AudioMixer4              mixer3;         //xy=485.5,645
 AudioMixer8              mixer8_1;       //xy=708.5,382
+AudioAnalyzeClip         clip1;          //xy=829.5,456
 AudioMixer4              mixer4;         //xy=829.5,216
+AudioFilterParametricEQ  peq1;           //xy=905.5,216
 AudioFilterBiquad        biquad1;        //xy=980.5,214
 AudioAnalyzePeak         peak2;          //xy=982.5,114
+AudioAnalyzeFFT256       fft256_2;       //xy=982.5,64
+AudioAnalyzeLoudness     loud2;          //xy=982.5,164
 AudioOutputI2S           i2s2;           //xy=1132.5,199
 AudioConnection          patchCord1(sine1, 0, mixer2, 0);
 AudioConnection          patchCord2(dc1, 0, mixer2, 1);
 AudioConnection          patchCord3(dc2, 0, filter1, 1);
 AudioConnection          patchCord4(sine2, 0, mixer1, 1);
-AudioConnection          patchCord5(i2s1, 0, mixer1, 0);
-AudioConnection          patchCord6(mixer1, 0, filter1, 0);
-AudioConnection          patchCord7(mixer1, peak1);
-AudioConnection          patchCord8(mixer1, flange1);
-AudioConnection          patchCord9(mixer1, 0, multiply1, 0);
-AudioConnection          patchCord10(mixer1, freeverb1);
-AudioConnection          patchCord11(mixer1, chorus1);
-AudioConnection          patchCord12(mixer1, 0, mixer4, 0);
-AudioConnection          patchCord13(mixer1, notefreq1);
-AudioConnection          patchCord14(mixer1, 0, mixer5, 0);
-AudioConnection          patchCord15(mixer2, 0, multiply1, 1);
-AudioConnection          patchCord16(mixer5, delayExt1);
-AudioConnection          patchCord17(chorus1, 0, mixer8_1, 1);
-AudioConnection          patchCord18(freeverb1, 0, mixer8_1, 0);
-AudioConnection          patchCord19(delayExt1, 0, mixer3, 0);
-AudioConnection          patchCord20(delayExt1, 1, mixer3, 1);
-AudioConnection          patchCord21(filter1, 0, mixer8_1, 2);
-AudioConnection          patchCord22(flange1, 0, mixer8_1, 3);
-AudioConnection          patchCord23(multiply1, 0, mixer8_1, 4);
-AudioConnection          patchCord24(mixer3, 0, mixer8_1, 5);
-AudioConnection          patchCord25(mixer3, 0, mixer5, 1);
-AudioConnection          patchCord26(mixer8_1, 0, mixer4, 1);
-AudioConnection          patchCord27(mixer4, biquad1);
-AudioConnection          patchCord28(mixer4, peak2);
-AudioConnection          patchCord29(biquad1, 0, i2s2, 0);
+AudioConnection          patchCord5(i2s1, gate1);
+AudioConnection          patchCord6(gate1, comp1);
+AudioConnection          patchCord7(comp1, 0, mixer1, 0);
+AudioConnection          patchCord8(mixer1, 0, filter1, 0);
+AudioConnection          patchCord9(mixer1, peak1);
+AudioConnection          patchCord10(mixer1, loud1);
+AudioConnection          patchCord11(mixer1, 0, clip1, 0);
+AudioConnection          patchCord12(mixer1, flange1);
+AudioConnection          patchCord13(mixer1, 0, multiply1, 0);
+AudioConnection          patchCord14(mixer1, freeverb1);
+AudioConnection          patchCord15(mixer1, chorus1);
+AudioConnection          patchCord16(mixer1, 0, mixer4, 0);
+AudioConnection          patchCord17(mixer1, pitch1);
+AudioConnection          patchCord18(mixer1, strum1);
+AudioConnection          patchCord19(mixer1, 0, mixer5, 0);
+AudioConnection          patchCord20(mixer1, shape1);
+AudioConnection          patchCord21(mixer2, 0, multiply1, 1);
+AudioConnection          patchCord22(mixer5, delayExt1);
+AudioConnection          patchCord23(chorus1, 0, mixer8_1, 1);
+AudioConnection          patchCord24(chorus1, 0, clip1, 1);
+AudioConnection          patchCord25(freeverb1, 0, mixer8_1, 0);
+AudioConnection          patchCord26(freeverb1, 0, clip1, 2);
+AudioConnection          patchCord27(delayExt1, 0, mixer3, 0);
+AudioConnection          patchCord28(delayExt1, 1, mixer3, 1);
+AudioConnection          patchCord29(filter1, 0, mixer8_1, 2);
+AudioConnection          patchCord30(flange1, 0, mixer8_1, 3);
+AudioConnection          patchCord31(multiply1, 0, mixer8_1, 4);
+AudioConnection          patchCord32(shape1, 0, mixer8_1, 6);
+AudioConnection          patchCord34(mixer3, 0, mixer8_1, 5);
+AudioConnection          patchCord35(mixer3, 0, mixer5, 1);
+AudioConnection          patchCord36(mixer3, 0, clip1, 3);
+AudioConnection          patchCord37(mixer8_1, 0, mixer4, 1);
+AudioConnection          patchCord38(mixer8_1, 0, clip1, 4);
+AudioConnection          patchCord39(mixer4, peq1);
+AudioConnection          patchCord40(peq1, biquad1);
+AudioConnection          patchCord41(peq1, 0, clip1, 6);
+AudioConnection          patchCord42(mixer4, peak2);
+AudioConnection          patchCord43(mixer4, loud2);
+AudioConnection          patchCord44(mixer4, 0, clip1, 5);
+AudioConnection          patchCord45(biquad1, 0, i2s2, 0);
 AudioControlSGTL5000     audioShield;    //xy=72.5,540
 // GUItool: end automatically generated code
 
+// only so dropout1 is updated
+AudioConnection          dropoutCord(i2s1, 0, dropout1, 0);
+
 
 
 
@@ -107,6 +150,7 @@ AudioControlSGTL5000     audioShield;    //xy=72.5,540
 #define FLANGER_IN      3
 #define TREMOLO_IN      4
 #define DELAY_IN        5
+#define SHAPER_IN       6
 
 
 // delay input mixer
@@ -118,6 +162,20 @@ AudioControlSGTL5000     audioShield;    //xy=72.5,540
 #define OUTPUT_MIXER    4
 #define DRY_OUT         0
 #define WET_OUT         1
+#define LOOP_OUT        2
+
+// clip detector 1 inputs, in chain order. shape1 isn't one,
+// its curves reach full scale on purpose, it's counted where
+// it's mixed in (mixer8_1)
+#define CLIP_INPUT      0
+#define CLIP_CHORUS     1
+#define CLIP_REVERB     2
+#define CLIP_DELAY      3
+#define CLIP_EFFECTS    4
+#define CLIP_OUTPUT     5
+#define CLIP_EQ         6
+
+const char *clipNames[CLIP_INPUTS] = {"mixer1", "chorus1", "freeverb1", "mixer3", "mixer8_1", "mixer4", "peq1"};
 
 
 #endif
@@ -0,0 +1,184 @@
+/******************************************************
+   pedal.h - wah-wah pedal (or pot) input
+
+   version 1.0   Oct 2026
+
+   The pedal is read every 5 ms from idle(), which runs while
+   the main loop waits and during the screens' delays and
+   messages (idleDelay), from ADC0 running continuously with
+   32 hardware averages (see initPots), so there's no waiting
+   on conversions. Only drawing holds it up.
+   The reading is smoothed, scaled between the calibrated
+   heel & toe readings and shaped by the response curve.
+
+   The wah filter is swept to each new position over the
+   time since the last reading (AudioSynthWaveformDc ramps
+   sample by sample), so it moves smoothly instead of
+   stepping every loop.
+
+   Calibrate with the 'P' serial command: rock the pedal
+   heel to toe for 5 seconds. The extents are stored in
+   cfg, so save the config to keep them. A pedal that reads
+   backwards can have heel > toe.
+
+   curves:   0 linear
+             1 slow heel  - more travel at the heel end
+             2 fast heel  - more travel at the toe end
+             3 s-curve    - more travel in the middle
+
+ ******************************************************/
+
+#ifndef PEDAL_H
+#define PEDAL_H
+
+
+#define NUM_PEDAL_CURVES  4
+enum pedalCurves {PEDAL_LINEAR, PEDAL_SLOW_HEEL, PEDAL_FAST_HEEL, PEDAL_S_CURVE};
+
+// smaller changes than this are ignored, 0 to 1.0
+#define PEDAL_DEADBAND    0.002
+
+// calibration
+#define PEDAL_CAL_MS      5000
+#define PEDAL_MIN_SPAN    400
+
+
+
+class Pedal {
+  public:
+    Pedal();
+    void init();
+    void poll();
+    void calibrate();
+    void printConfig();
+
+  private:
+    static const uint8_t pollMs = 5;
+    // after a long screen draw, catch up this quickly
+    static const uint8_t maxRampMs = 50;
+
+    elapsedMillis pollTime;
+    float smoothed;
+    float lastPos;
+
+    float shape(float x);
+};
+
+
+
+Pedal :: Pedal()
+{
+  smoothed = 0;
+  lastPos = -1;
+}
+
+
+
+// run after initPots
+void Pedal :: init()
+{
+  smoothed = readPedal();
+  pollTime = 0;
+}
+
+
+
+// called from idle()
+void Pedal :: poll()
+{
+  if (pollTime < pollMs)
+    return;
+
+  float ms = min((uint32_t)pollTime, (uint32_t)maxRampMs);
+  pollTime = 0;
+
+  smoothed += 0.5 * (readPedal() - smoothed);
+
+  float span = cfg.pedalToe - cfg.pedalHeel;
+  if (span == 0)
+    return;
+  float pos = shape(constrain((smoothed - cfg.pedalHeel) / span, 0, 1.0));
+
+  // only when it moves, so other controls (midi) aren't overridden
+  if (fabsf(pos - lastPos) < PEDAL_DEADBAND)
+    return;
+
+  wahwah.setPosition(pos, ms);
+  lastPos = pos;
+}
+
+
+
+float Pedal :: shape(float x)
+{
+  switch (cfg.pedalCurve)
+  {
+    case PEDAL_SLOW_HEEL:
+      return x * x;
+    case PEDAL_FAST_HEEL:
+      return sqrtf(x);
+    case PEDAL_S_CURVE:
+      return x * x * (3.0 - 2.0 * x);
+    default:
+      return x;
+  }
+}
+
+
+
+// find the heel & toe readings, keeps a reversed pedal reversed
+void Pedal :: calibrate()
+{
+  int16_t lo = 4095;
+  int16_t hi = 0;
+
+  Serial.println(F("Rock the pedal heel to toe for 5 seconds..."));
+
+  elapsedMillis calTime;
+  while (calTime < PEDAL_CAL_MS)
+  {
+    int16_t raw = readPedal();
+    lo = min(lo, raw);
+    hi = max(hi, raw);
+    delay(2);
+  }
+
+  if (hi - lo < PEDAL_MIN_SPAN)
+  {
+    Serial.println(F("Pedal didn't move enough, calibration not changed"));
+    return;
+  }
+
+  // a little in from the ends so both are always reached
+  int16_t margin = (hi - lo) / 100;
+  lo += margin;
+  hi -= margin;
+
+  if (cfg.pedalHeel > cfg.pedalToe)
+  {
+    cfg.pedalHeel = hi;
+    cfg.pedalToe = lo;
+  }
+  else
+  {
+    cfg.pedalHeel = lo;
+    cfg.pedalToe = hi;
+  }
+  lastPos = -1;
+
+  printValue("Pedal heel", cfg.pedalHeel);
+  printValue("Pedal toe ", cfg.pedalToe);
+  Serial.println(F("Save the config to keep it"));
+}
+
+
+
+void Pedal :: printConfig()
+{
+  Serial.print("Pedal Heel      = "); Serial.println(cfg.pedalHeel);
+  Serial.print("Pedal Toe       = "); Serial.println(cfg.pedalToe);
+  Serial.print("Pedal Curve     = "); Serial.println(cfg.pedalCurve);
+  Serial.print("Pedal Position  = "); Serial.println(lastPos);
+}
+
+#endif
@@ -0,0 +1,151 @@
+/******************************************************
+   presets.h - presets stored in EEPROM
+
+   version 1.0   Oct 2026
+
+   A preset is a copy of all the settings (cfg) plus which
+   effects are on. NUM_PRESETS of them are kept in EEPROM
+   after the saved config. Presets saved by a different
+   EEPROM_VERSION are ignored.
+
+   Saved & recalled with the serial console (store / recall)
+   or recalled by MIDI program change (midi.h). The SD card
+   library (library.h) keeps more of them in the same form.
+
+ ******************************************************/
+
+#ifndef PRESETS_H
+#define PRESETS_H
+
+
+#define NUM_PRESETS   8
+#define PRESET_ADDR   (EEPROM_ADDR + sizeof(Config))
+
+
+// one bit per effect, in this order
+#define NUM_EFFECTS   10
+enum effectBits {COMP_BIT, EQ_BIT, REVERB_BIT, DELAY_BIT, TREMOLO_BIT,
+                 FLANGER_BIT, WAHWAH_BIT, CHORUS_BIT, SHAPER_BIT, GATE_BIT
+                };
+
+
+struct Preset
+{
+  Config   cfg;
+  uint16_t effects;
+};
+
+static_assert(PRESET_ADDR + NUM_PRESETS * sizeof(Preset) <= E2END + 1, "presets don't fit in EEPROM");
+
+
+// prototypes
+uint16_t effectsMask();
+void setEffects(uint16_t mask);
+bool savePreset(uint8_t n);
+bool loadPreset(uint8_t n);
+void applyPreset(const Preset &p);
+void printEffects(uint16_t mask);
+
+
+
+// which effects are on
+uint16_t effectsMask()
+{
+  uint16_t mask = 0;
+
+  mask |= compressor.enabled << COMP_BIT;
+  mask |= eq.enabled         << EQ_BIT;
+  mask |= reverb.enabled     << REVERB_BIT;
+  mask |= delayer.enabled    << DELAY_BIT;
+  mask |= tremolo.enabled    << TREMOLO_BIT;
+  mask |= flanger.enabled    << FLANGER_BIT;
+  mask |= wahwah.enabled     << WAHWAH_BIT;
+  mask |= chorus.enabled     << CHORUS_BIT;
+  mask |= waveshaper.enabled << SHAPER_BIT;
+  mask |= noiseGate.enabled  << GATE_BIT;
+  return mask;
+}
+
+
+
+// turn effects on or off to match the mask
+void setEffects(uint16_t mask)
+{
+  memProfileSample();
+  if ((mask >> COMP_BIT) & 1)     compressor.enable(); else compressor.disable();
+  if ((mask >> EQ_BIT) & 1)       eq.enable();         else eq.disable();
+  if ((mask >> REVERB_BIT) & 1)   reverb.enable();     else reverb.disable();
+  if ((mask >> DELAY_BIT) & 1)    delayer.enable();    else delayer.disable();
+  if ((mask >> TREMOLO_BIT) & 1)  tremolo.enable();    else tremolo.disable();
+  if ((mask >> FLANGER_BIT) & 1)  flanger.enable();    else flanger.disable();
+  if ((mask >> WAHWAH_BIT) & 1)   wahwah.enable();     else wahwah.disable();
+  if ((mask >> CHORUS_BIT) & 1)   chorus.enable();     else chorus.disable();
+  if ((mask >> SHAPER_BIT) & 1)   waveshaper.enable(); else waveshaper.disable();
+  if ((mask >> GATE_BIT) & 1)     noiseGate.enable();  else noiseGate.disable();
+}
+
+
+
+// one letter per effect on, the same as the serial commands
+void printEffects(uint16_t mask)
+{
+  const char letters[] = "CERDTFWcSG";
+
+  for (uint8_t b = 0; b < NUM_EFFECTS; b++)
+    Serial.print((mask >> b) & 1 ? letters[b] : '-');
+}
+
+
+
+bool savePreset(uint8_t n)
+{
+  if (n >= NUM_PRESETS || EEPROM_VERSION == 0)
+    return false;
+
+  Preset p;
+  p.cfg = cfg;
+  p.cfg.vers = EEPROM_VERSION;
+  p.effects = effectsMask();
+  EEPROM.put(PRESET_ADDR + n * sizeof(Preset), p);
+
+  printValue("Saved preset", n);
+  return true;
+}
+
+
+
+bool loadPreset(uint8_t n)
+{
+  if (n >= NUM_PRESETS)
+    return false;
+
+  Preset p;
+  EEPROM.get(PRESET_ADDR + n * sizeof(Preset), p);
+  if (p.cfg.vers != EEPROM_VERSION)
+  {
+    printValue("Empty preset", n);
+    return false;
+  }
+
+  applyPreset(p);
+  printValue("Loaded preset", n);
+  return true;
+}
+
+
+
+// settings & effects from the preset, the screen shown
+// doesn't change
+void applyPreset(const Preset &p)
+{
+  uint8_t menu = cfg.lastMenu;
+  cfg = p.cfg;
+  cfg.lastMenu = menu;
+
+  updateAudio();
+  setEffects(p.effects);
+  updateLEDs();
+  initScreen = true;
+}
+
+#endif
@@ -0,0 +1,361 @@
+/******************************************************
+   protocol.h - binary serial control protocol
+
+   version 1.0   Oct 2026
+
+   Framed, CRC checked commands over the USB serial port
+   for a host program (see tools/gep_client.py). Text
+   commands (doSerialCommands) still work alongside, a
+   frame always starts with the sync byte, which isn't a
+   printable character.
+
+   frame:  SYNC  LEN  CMD  payload[LEN]  CRC lo  CRC hi
+
+     SYNC  0xA5
+     LEN   payload length, 0 to PROTO_MAX_PAYLOAD
+     CRC   CRC16-CCITT (0x1021, init 0xFFFF) of LEN, CMD
+           and the payload
+
+   Multi-byte values are little-endian, values are floats.
+   Replies use the command with the high bit set.
+
+     PING    0x01                 -> 0x81 eeprom vers, num params
+     LIST    0x02                 -> 0x82 per param:
+                                     id, type, min, max, name
+     GET     0x03 id...           -> 0x83 (id, value)...
+     SET     0x04 (id, value)...  -> 0x84 count set
+     STREAM  0x05 period ms (u16) -> 0x85 meters every period,
+                                     0 = stop
+     SAVE    0x06                 -> 0x86 1 if saved
+     error                        -> 0xFF cmd, error code
+
+   A SET frame can change up to 50 params, each effect is
+   updated once after all of them are set. The whole frame
+   is handled in one pass of the main loop.
+
+   meters:  cpu %, cpu max %, audio blocks, blocks max,
+            input & output loudness (LUFS)
+
+   A partial frame is dropped after 100 ms with no data.
+
+ ******************************************************/
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "params.h"
+
+
+#define PROTO_SYNC          0xA5
+#define PROTO_MAX_PAYLOAD   252
+
+#define PROTO_PING          0x01
+#define PROTO_LIST          0x02
+#define PROTO_GET           0x03
+#define PROTO_SET           0x04
+#define PROTO_STREAM        0x05
+#define PROTO_SAVE          0x06
+#define PROTO_REPLY         0x80
+#define PROTO_METERS        0x85
+#define PROTO_NAK           0xFF
+
+// error codes
+#define PROTO_ERR_CRC       1
+#define PROTO_ERR_CMD       2
+#define PROTO_ERR_LENGTH    3
+#define PROTO_ERR_PARAM     4
+
+#define PROTO_TIMEOUT       100
+
+
+
+// CRC16-CCITT, one byte at a time
+uint16_t crc16(uint16_t crc, uint8_t data)
+{
+  crc ^= (uint16_t)data << 8;
+  for (uint8_t i = 0; i < 8; i++)
+    crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+  return crc;
+}
+
+
+
+class Protocol {
+  public:
+    Protocol();
+    void poll();
+
+  private:
+    // receive state
+    enum {WAIT_SYNC, WAIT_LEN, WAIT_CMD, WAIT_DATA, WAIT_CRC_LO, WAIT_CRC_HI};
+    uint8_t state;
+    uint8_t len;
+    uint8_t cmd;
+    uint8_t count;
+    uint16_t crc;
+    uint16_t rxCrc;
+    uint8_t payload[PROTO_MAX_PAYLOAD];
+    elapsedMillis byteTime;
+
+    // meter streaming
+    uint16_t streamPeriod;
+    elapsedMillis streamTime;
+
+    bool receive(uint8_t b);
+    void handleFrame();
+    void doList();
+    void doGet();
+    void doSet();
+    void sendMeters();
+    void sendFrame(uint8_t c, const uint8_t *data, uint8_t n);
+    void sendNak(uint8_t code);
+};
+
+
+
+Protocol :: Protocol()
+{
+  state = WAIT_SYNC;
+  streamPeriod = 0;
+}
+
+
+
+// called from the main loop. Only takes bytes from the port
+// when they're part of a frame, leaving text commands
+void Protocol :: poll()
+{
+  if (state != WAIT_SYNC && byteTime > PROTO_TIMEOUT)
+    state = WAIT_SYNC;
+
+  while (Serial.available())
+  {
+    if (state == WAIT_SYNC && Serial.peek() != PROTO_SYNC)
+      break;
+    if (receive(Serial.read()))
+      handleFrame();
+  }
+
+  if (streamPeriod && streamTime >= streamPeriod)
+  {
+    streamTime = 0;
+    sendMeters();
+  }
+}
+
+
+
+// true when a complete frame is received
+bool Protocol :: receive(uint8_t b)
+{
+  byteTime = 0;
+
+  switch (state)
+  {
+    case WAIT_SYNC:
+      if (b == PROTO_SYNC)
+        state = WAIT_LEN;
+      break;
+
+    case WAIT_LEN:
+      if (b > PROTO_MAX_PAYLOAD)
+      {
+        state = WAIT_SYNC;
+        break;
+      }
+      len = b;
+      crc = crc16(0xFFFF, b);
+      state = WAIT_CMD;
+      break;
+
+    case WAIT_CMD:
+      cmd = b;
+      crc = crc16(crc, b);
+      count = 0;
+      state = len ? WAIT_DATA : WAIT_CRC_LO;
+      break;
+
+    case WAIT_DATA:
+      payload[count++] = b;
+      crc = crc16(crc, b);
+      if (count == len)
+        state = WAIT_CRC_LO;
+      break;
+
+    case WAIT_CRC_LO:
+      rxCrc = b;
+      state = WAIT_CRC_HI;
+      break;
+
+    case WAIT_CRC_HI:
+      rxCrc |= (uint16_t)b << 8;
+      state = WAIT_SYNC;
+      if (rxCrc == crc)
+        return true;
+      sendNak(PROTO_ERR_CRC);
+      break;
+  }
+  return false;
+}
+
+
+
+void Protocol :: handleFrame()
+{
+  uint8_t reply[4];
+
+  switch (cmd)
+  {
+    case PROTO_PING:
+      reply[0] = EEPROM_VERSION;
+      reply[1] = NUM_PARAMS;
+      sendFrame(cmd | PROTO_REPLY, reply, 2);
+      break;
+
+    case PROTO_LIST:
+      doList();
+      break;
+
+    case PROTO_GET:
+      doGet();
+      break;
+
+    case PROTO_SET:
+      doSet();
+      break;
+
+    case PROTO_STREAM:
+      if (len != 2)
+      {
+        sendNak(PROTO_ERR_LENGTH);
+        break;
+      }
+      streamPeriod = payload[0] | payload[1] << 8;
+      streamTime = 0;
+      break;
+
+    case PROTO_SAVE:
+      reply[0] = saveConfig();
+      sendFrame(PROTO_SAVE | PROTO_REPLY, reply, 1);
+      break;
+
+    default:
+      sendNak(PROTO_ERR_CMD);
+  }
+}
+
+
+
+void Protocol :: doList()
+{
+  uint8_t data[10 + 32];
+
+  for (uint8_t id = 0; id < NUM_PARAMS; id++)
+  {
+    const Param &p = params[id];
+    uint8_t n = min(strlen(p.name), (size_t)32);
+
+    data[0] = id;
+    data[1] = p.type;
+    memcpy(&data[2], &p.minVal, 4);
+    memcpy(&data[6], &p.maxVal, 4);
+    memcpy(&data[10], p.name, n);
+    sendFrame(PROTO_LIST | PROTO_REPLY, data, 10 + n);
+  }
+}
+
+
+
+void Protocol :: doGet()
+{
+  // 5 bytes per value, so fewer can be returned than asked for
+  uint8_t data[PROTO_MAX_PAYLOAD];
+  uint8_t n = 0;
+
+  for (uint8_t i = 0; i < len && n + 5 <= PROTO_MAX_PAYLOAD; i++)
+  {
+    if (payload[i] >= NUM_PARAMS)
+    {
+      sendNak(PROTO_ERR_PARAM);
+      return;
+    }
+    float value = getParam(payload[i]);
+    data[n] = payload[i];
+    memcpy(&data[n + 1], &value, 4);
+    n += 5;
+  }
+  sendFrame(PROTO_GET | PROTO_REPLY, data, n);
+}
+
+
+
+// set them all, then update each effect once
+void Protocol :: doSet()
+{
+  uint8_t ids[PROTO_MAX_PAYLOAD / 5];
+  uint8_t n = 0;
+
+  if (len % 5)
+  {
+    sendNak(PROTO_ERR_LENGTH);
+    return;
+  }
+
+  for (uint8_t i = 0; i < len; i += 5)
+  {
+    float value;
+    memcpy(&value, &payload[i + 1], 4);
+    if (setParam(payload[i], value, false))
+      ids[n++] = payload[i];
+  }
+  applyParams(ids, n);
+
+  if (n < len / 5)
+  {
+    sendNak(PROTO_ERR_PARAM);
+    return;
+  }
+  sendFrame(PROTO_SET | PROTO_REPLY, &n, 1);
+}
+
+
+
+void Protocol :: sendMeters()
+{
+  float meters[6];
+
+  meters[0] = AudioProcessorUsage();
+  meters[1] = AudioProcessorUsageMax();
+  meters[2] = AudioMemoryUsage();
+  meters[3] = AudioMemoryUsageMax();
+  // peek, so the Levels screen still sees the new readings
+  meters[4] = loud1.peekLoudness();
+  meters[5] = loud2.peekLoudness();
+  sendFrame(PROTO_METERS, (uint8_t *)meters, sizeof(meters));
+}
+
+
+
+void Protocol :: sendFrame(uint8_t c, const uint8_t *data, uint8_t n)
+{
+  uint8_t header[3] = {PROTO_SYNC, n, c};
+  uint16_t sum = crc16(crc16(0xFFFF, n), c);
+
+  for (uint8_t i = 0; i < n; i++)
+    sum = crc16(sum, data[i]);
+
+  Serial.write(header, 3);
+  Serial.write(data, n);
+  Serial.write((uint8_t)(sum & 0xFF));
+  Serial.write((uint8_t)(sum >> 8));
+}
+
+
+
+void Protocol :: sendNak(uint8_t code)
+{
+  uint8_t data[2] = {cmd, code};
+  sendFrame(PROTO_NAK, data, 2);
+}
+
+#endif
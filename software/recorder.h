@@ -0,0 +1,438 @@
+/******************************************************
+   recorder.h - records the output to a WAV file on the
+   SD card
+
+   version 1.0   Oct 2026
+
+   Records practice sessions to RECnnn.WAV on the SD card
+   (the built-in slot on a 3.5/3.6). Only built with
+   USE_SD_CARD (hardware.h). The 'r' serial command starts
+   & stops it.
+
+   The output (biquad1, what goes to the line out) is mono.
+   With rec.dry on, the dry input (after the input level)
+   is added as the right channel, for reamping later.
+
+   Blocks are collected from AudioRecordQueues into two
+   4K buffers. When one is full it's written from idle()
+   (Teensy_GEP.ino) while the other fills, so it keeps up
+   through the screens' delays & messages too. Writes are
+   always whole 512 byte sectors: the header is padded to
+   512 bytes with a JUNK chunk, which players skip. Each
+   write is timed & the longest is kept. The queues hold
+   about 150ms, a write (or screen draw) that takes longer
+   than that loses blocks, which are counted from the
+   elapsed time.
+
+   Audio chain:
+   Biquad1 -> RecQueue1 (left)
+   I2S1    -> RecQueue2 (right, with rec.dry)
+
+ ******************************************************/
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#ifdef USE_SD_CARD
+
+
+#define REC_BUFFER_BYTES    4096
+#define REC_HEADER_BYTES    512
+#define REC_MAX_FILES       1000
+
+// one audio block, in microseconds
+#define REC_BLOCK_US        (AUDIO_BLOCK_SAMPLES * 1000000.0 / AUDIO_SAMPLE_RATE_EXACT)
+
+
+AudioRecordQueue  recQueue1;
+AudioRecordQueue  recQueue2;
+
+AudioConnection   recWetCord(biquad1, 0, recQueue1, 0);
+AudioConnection   recDryCord(i2s1, 0, recQueue2, 0);
+
+
+
+class Recorder {
+  public:
+    Recorder();
+    void init();
+    void start();
+    void stop();
+    void toggle();
+    void poll();
+    void printConfig();
+    bool recordingDry();
+    bool dry;
+    bool recording;
+
+  private:
+    bool cardPresent;
+    File file;
+    char fileName[12];
+    uint8_t channels;
+
+    // filled & written in turn
+    uint8_t buffer[2][REC_BUFFER_BYTES] __attribute__((aligned(4)));
+    uint8_t fillBuffer;
+    uint16_t fillBytes;
+    int8_t readyBuffer;
+
+    uint32_t startMicros;
+    uint32_t blocks;
+    uint32_t dataBytes;
+    uint32_t dropped;
+    uint32_t writes;
+    uint32_t writeTotalUs;
+    uint32_t writeMaxUs;
+    bool writeFailed;
+
+    bool blockReady();
+    void collect();
+    bool writeBuffer(const uint8_t *data, uint16_t bytes);
+    void makeHeader(uint8_t *header);
+    void putLong(uint8_t *p, uint32_t v);
+    void putShort(uint8_t *p, uint16_t v);
+    void printReport();
+};
+
+
+
+
+Recorder :: Recorder()
+{
+  dry = false;
+  recording = false;
+  cardPresent = false;
+}
+
+
+
+// run after audio board is initialized
+void Recorder :: init()
+{
+  cardPresent = initSDCard();
+  if (cardPresent)
+    printValue("SD card recorder initialized");
+  else
+    printValue("no SD card, recorder off");
+}
+
+
+
+void Recorder :: start()
+{
+  if (recording)
+    return;
+
+  if (!cardPresent)
+  {
+    Serial.println(F("No SD card"));
+    return;
+  }
+
+  // next unused name
+  uint16_t n;
+  for (n = 0; n < REC_MAX_FILES; n++)
+  {
+    sprintf(fileName, "REC%03u.WAV", n);
+    if (!SD.exists(fileName))
+      break;
+  }
+  if (n == REC_MAX_FILES)
+  {
+    Serial.println(F("SD card full of recordings"));
+    return;
+  }
+
+  file = SD.open(fileName, FILE_WRITE);
+  if (!file)
+  {
+    Serial.print(F("Can't create ")); Serial.println(fileName);
+    return;
+  }
+
+  channels = dry ? 2 : 1;
+  dataBytes = 0;
+  blocks = 0;
+  dropped = 0;
+  writeFailed = false;
+
+  // sizes are filled in when stopped
+  makeHeader(buffer[0]);
+  if (!writeBuffer(buffer[0], REC_HEADER_BYTES))
+  {
+    file.close();
+    Serial.print(F("Can't write ")); Serial.println(fileName);
+    return;
+  }
+  dataBytes = 0;
+  writes = 0;
+  writeTotalUs = 0;
+  writeMaxUs = 0;
+
+  fillBuffer = 0;
+  fillBytes = 0;
+  readyBuffer = -1;
+
+  // both queues start on the same block
+  memProfileSample();
+  AudioNoInterrupts();
+  recQueue1.begin();
+  if (dry)
+    recQueue2.begin();
+  startMicros = micros();
+  AudioInterrupts();
+
+  recording = true;
+  Serial.print(F("Recording to ")); Serial.println(fileName);
+}
+
+
+
+void Recorder :: stop()
+{
+  if (!recording)
+    return;
+
+  memProfileSample();
+  AudioNoInterrupts();
+  recQueue1.end();
+  recQueue2.end();
+  uint32_t expected = (micros() - startMicros) / REC_BLOCK_US;
+  AudioInterrupts();
+
+  // whatever is left in the queues & buffers
+  while (!writeFailed)
+  {
+    if (readyBuffer >= 0)
+    {
+      writeBuffer(buffer[readyBuffer], REC_BUFFER_BYTES);
+      readyBuffer = -1;
+    }
+    if (!blockReady())
+      break;
+    collect();
+  }
+  if (!writeFailed && fillBytes > 0)
+    writeBuffer(buffer[fillBuffer], fillBytes);
+
+  recQueue1.clear();
+  recQueue2.clear();
+
+  // one block may have been on its way
+  if (expected > blocks + 1)
+    dropped = expected - blocks - 1;
+
+  makeHeader(buffer[0]);
+  file.seek(0);
+  file.write(buffer[0], REC_HEADER_BYTES);
+  file.close();
+
+  recording = false;
+  printReport();
+}
+
+
+
+void Recorder :: toggle()
+{
+  if (recording)
+    stop();
+  else
+    start();
+}
+
+
+
+// with the second queue
+bool Recorder :: recordingDry()
+{
+  return recording && channels == 2;
+}
+
+
+
+// called from idle(), writes at most one buffer each time
+void Recorder :: poll()
+{
+  if (!recording)
+    return;
+
+  collect();
+
+  if (readyBuffer >= 0)
+  {
+    if (!writeBuffer(buffer[readyBuffer], REC_BUFFER_BYTES))
+    {
+      Serial.println(F("SD card write failed"));
+      stop();
+      return;
+    }
+    readyBuffer = -1;
+    collect();
+  }
+}
+
+
+
+bool Recorder :: blockReady()
+{
+  if (channels == 2)
+    return recQueue1.available() > 0 && recQueue2.available() > 0;
+  return recQueue1.available() > 0;
+}
+
+
+
+// move blocks from the queues to the buffers, until both
+// buffers are full
+void Recorder :: collect()
+{
+  while (blockReady())
+  {
+    if (fillBytes == REC_BUFFER_BYTES)
+    {
+      if (readyBuffer >= 0)
+        return;
+      readyBuffer = fillBuffer;
+      fillBuffer ^= 1;
+      fillBytes = 0;
+    }
+
+    int16_t *dest = (int16_t *)&buffer[fillBuffer][fillBytes];
+    int16_t *left = recQueue1.readBuffer();
+
+    if (channels == 2)
+    {
+      int16_t *right = recQueue2.readBuffer();
+      for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+      {
+        *dest++ = left[i];
+        *dest++ = right[i];
+      }
+      recQueue2.freeBuffer();
+    }
+    else
+      memcpy(dest, left, AUDIO_BLOCK_SAMPLES * 2);
+
+    recQueue1.freeBuffer();
+    fillBytes += AUDIO_BLOCK_SAMPLES * 2 * channels;
+    blocks++;
+  }
+
+  // hand a full buffer over now rather than on the next block
+  if (fillBytes == REC_BUFFER_BYTES && readyBuffer < 0)
+  {
+    readyBuffer = fillBuffer;
+    fillBuffer ^= 1;
+    fillBytes = 0;
+  }
+}
+
+
+
+// timed, false if the card didn't take it all
+bool Recorder :: writeBuffer(const uint8_t *data, uint16_t bytes)
+{
+  dropout1.activityStart(ACT_SD);
+  uint32_t t = micros();
+  size_t written = file.write(data, bytes);
+  t = micros() - t;
+  dropout1.activityEnd(ACT_SD);
+
+  writes++;
+  writeTotalUs += t;
+  writeMaxUs = max(writeMaxUs, t);
+
+  if (written != bytes)
+  {
+    writeFailed = true;
+    return false;
+  }
+
+  dataBytes += bytes;
+  return true;
+}
+
+
+
+// 16 bit PCM, padded with a JUNK chunk so the audio
+// starts on a sector
+void Recorder :: makeHeader(uint8_t *header)
+{
+  uint32_t rate = AUDIO_SAMPLE_RATE_EXACT + 0.5;
+  uint16_t align = channels * 2;
+  uint32_t junk = REC_HEADER_BYTES - 12 - 24 - 8 - 8;
+
+  memset(header, 0, REC_HEADER_BYTES);
+
+  // all little endian, like the teensy
+  memcpy(&header[0], "RIFF", 4);
+  putLong(&header[4], REC_HEADER_BYTES - 8 + dataBytes);
+  memcpy(&header[8], "WAVE", 4);
+
+  memcpy(&header[12], "fmt ", 4);
+  putLong(&header[16], 16);
+  putShort(&header[20], 1);
+  putShort(&header[22], channels);
+  putLong(&header[24], rate);
+  putLong(&header[28], rate * align);
+  putShort(&header[32], align);
+  putShort(&header[34], 16);
+
+  memcpy(&header[36], "JUNK", 4);
+  putLong(&header[40], junk);
+
+  memcpy(&header[REC_HEADER_BYTES - 8], "data", 4);
+  putLong(&header[REC_HEADER_BYTES - 4], dataBytes);
+}
+
+
+
+void Recorder :: putLong(uint8_t *p, uint32_t v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+
+
+void Recorder :: putShort(uint8_t *p, uint16_t v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+
+
+void Recorder :: printReport()
+{
+  Serial.print(F("Recorded ")); Serial.print(fileName);
+  Serial.print(F(", ")); Serial.print(dataBytes / (2.0 * channels * AUDIO_SAMPLE_RATE_EXACT));
+  Serial.println(F(" sec"));
+  Serial.print(F("Dropped blocks  = ")); Serial.println(dropped);
+  Serial.print(F("SD writes       = ")); Serial.println(writes);
+  Serial.print(F("Write avg us    = ")); Serial.println(writes ? writeTotalUs / writes : 0);
+  Serial.print(F("Write max us    = ")); Serial.println(writeMaxUs);
+  if (writeFailed)
+    Serial.println(F("SD card write failed, recording is short"));
+}
+
+
+
+void Recorder :: printConfig()
+{
+  Serial.print("SD Card         = "); Serial.println(cardPresent);
+  Serial.print("Rec Dry Right   = "); Serial.println(dry);
+  Serial.print("Recording       = "); Serial.println(recording);
+  if (recording)
+  {
+    Serial.print("Rec Max Write us= "); Serial.println(writeMaxUs);
+    Serial.print("Rec Blocks      = "); Serial.println(blocks);
+  }
+}
+
+#endif
+#endif
@@ -0,0 +1,199 @@
+/**************************************************************
+    shapeCurves.h - transfer curves for the waveshaper
+
+    version 1.0   Oct 2026
+
+    Each curve is a 257 entry int16 table covering input
+    -1.0 to +1.0 (-32768 to +32767). The waveshaper uses the
+    top 8 bits of the sample to pick an entry and the lower
+    8 bits to interpolate to the next one, which is why the
+    tables have one extra point.
+
+    To add a new drive character, add a table below and an
+    entry to shapeCurves[] & shapeCurveNames[]. No changes to
+    the audio code are needed.
+
+    Tables were generated with:
+      y = f(-1.0 + 2.0 * i / 256) * 32767,  i = 0 to 256
+
+      Soft: tanh(2.5x) / tanh(2.5)
+      Hard: 2x, clipped at +/- 1.0
+      Tube: asymmetric exponential, negative half is
+            softer and 30% lower (even harmonics)
+              x >= 0:  (1 - exp(-3x)) / (1 - exp(-3))
+              x < 0:   -0.7 * (1 - exp(1.5x)) / (1 - exp(-1.5))
+      Fold: sin(0.9 * pi * x), folds back near full scale
+
+ **************************************************************/
+
+#ifndef SHAPE_CURVES_H
+#define SHAPE_CURVES_H
+
+#define SHAPE_TABLE_SIZE  257
+#define NUM_SHAPE_CURVES  4
+
+
+const PROGMEM int16_t shapeCurveSoft[SHAPE_TABLE_SIZE] =
+{
+  -32767, -32749, -32731, -32712, -32692, -32672, -32651, -32628,
+  -32605, -32581, -32557, -32531, -32504, -32476, -32447, -32417,
+  -32386, -32353, -32320, -32285, -32248, -32210, -32171, -32130,
+  -32088, -32044, -31998, -31951, -31902, -31851, -31798, -31743,
+  -31685, -31626, -31564, -31500, -31434, -31365, -31294, -31220,
+  -31143, -31063, -30980, -30895, -30806, -30713, -30618, -30519,
+  -30416, -30309, -30199, -30085, -29966, -29844, -29716, -29585,
+  -29449, -29307, -29161, -29010, -28854, -28692, -28525, -28352,
+  -28173, -27988, -27797, -27599, -27395, -27185, -26967, -26743,
+  -26511, -26272, -26025, -25771, -25509, -25239, -24961, -24675,
+  -24380, -24076, -23764, -23443, -23113, -22774, -22426, -22068,
+  -21701, -21325, -20939, -20543, -20138, -19723, -19298, -18863,
+  -18419, -17965, -17501, -17028, -16545, -16053, -15551, -15040,
+  -14520, -13991, -13453, -12906, -12351, -11788, -11218, -10639,
+  -10053,  -9461,  -8862,  -8256,  -7644,  -7028,  -6405,  -5779,
+   -5147,  -4513,  -3874,  -3233,  -2589,  -1944,  -1297,   -649,
+       0,    649,   1297,   1944,   2589,   3233,   3874,   4513,
+    5147,   5779,   6405,   7028,   7644,   8256,   8862,   9461,
+   10053,  10639,  11218,  11788,  12351,  12906,  13453,  13991,
+   14520,  15040,  15551,  16053,  16545,  17028,  17501,  17965,
+   18419,  18863,  19298,  19723,  20138,  20543,  20939,  21325,
+   21701,  22068,  22426,  22774,  23113,  23443,  23764,  24076,
+   24380,  24675,  24961,  25239,  25509,  25771,  26025,  26272,
+   26511,  26743,  26967,  27185,  27395,  27599,  27797,  27988,
+   28173,  28352,  28525,  28692,  28854,  29010,  29161,  29307,
+   29449,  29585,  29716,  29844,  29966,  30085,  30199,  30309,
+   30416,  30519,  30618,  30713,  30806,  30895,  30980,  31063,
+   31143,  31220,  31294,  31365,  31434,  31500,  31564,  31626,
+   31685,  31743,  31798,  31851,  31902,  31951,  31998,  32044,
+   32088,  32130,  32171,  32210,  32248,  32285,  32320,  32353,
+   32386,  32417,  32447,  32476,  32504,  32531,  32557,  32581,
+   32605,  32628,  32651,  32672,  32692,  32712,  32731,  32749,
+   32767
+};
+
+
+const PROGMEM int16_t shapeCurveHard[SHAPE_TABLE_SIZE] =
+{
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32255, -31743, -31231, -30719, -30207, -29695, -29183,
+  -28671, -28159, -27647, -27135, -26623, -26111, -25599, -25087,
+  -24575, -24063, -23551, -23039, -22527, -22015, -21503, -20991,
+  -20479, -19967, -19455, -18943, -18431, -17919, -17407, -16895,
+  -16384, -15872, -15360, -14848, -14336, -13824, -13312, -12800,
+  -12288, -11776, -11264, -10752, -10240,  -9728,  -9216,  -8704,
+   -8192,  -7680,  -7168,  -6656,  -6144,  -5632,  -5120,  -4608,
+   -4096,  -3584,  -3072,  -2560,  -2048,  -1536,  -1024,   -512,
+       0,    512,   1024,   1536,   2048,   2560,   3072,   3584,
+    4096,   4608,   5120,   5632,   6144,   6656,   7168,   7680,
+    8192,   8704,   9216,   9728,  10240,  10752,  11264,  11776,
+   12288,  12800,  13312,  13824,  14336,  14848,  15360,  15872,
+   16384,  16895,  17407,  17919,  18431,  18943,  19455,  19967,
+   20479,  20991,  21503,  22015,  22527,  23039,  23551,  24063,
+   24575,  25087,  25599,  26111,  26623,  27135,  27647,  28159,
+   28671,  29183,  29695,  30207,  30719,  31231,  31743,  32255,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767
+};
+
+
+const PROGMEM int16_t shapeCurveTube[SHAPE_TABLE_SIZE] =
+{
+  -22937, -22859, -22781, -22701, -22621, -22539, -22457, -22374,
+  -22289, -22204, -22118, -22031, -21942, -21853, -21762, -21671,
+  -21578, -21485, -21390, -21294, -21197, -21099, -20999, -20899,
+  -20797, -20694, -20590, -20485, -20378, -20271, -20162, -20051,
+  -19939, -19826, -19712, -19597, -19479, -19361, -19241, -19120,
+  -18997, -18873, -18748, -18621, -18492, -18362, -18231, -18097,
+  -17963, -17826, -17689, -17549, -17408, -17265, -17120, -16974,
+  -16826, -16677, -16525, -16372, -16217, -16060, -15901, -15741,
+  -15578, -15414, -15248, -15079, -14909, -14737, -14562, -14386,
+  -14208, -14027, -13844, -13659, -13472, -13283, -13092, -12898,
+  -12702, -12504, -12303, -12100, -11895, -11687, -11477, -11264,
+  -11049, -10831, -10610, -10388, -10162,  -9934,  -9703,  -9469,
+   -9233,  -8994,  -8751,  -8507,  -8259,  -8008,  -7755,  -7498,
+   -7238,  -6976,  -6710,  -6441,  -6169,  -5893,  -5615,  -5333,
+   -5048,  -4759,  -4467,  -4172,  -3873,  -3571,  -3265,  -2955,
+   -2642,  -2325,  -2005,  -1680,  -1352,  -1020,   -684,   -344,
+       0,    799,   1579,   2341,   3086,   3813,   4524,   5218,
+    5896,   6558,   7205,   7837,   8454,   9057,   9646,  10221,
+   10783,  11332,  11869,  12393,  12904,  13404,  13893,  14370,
+   14836,  15291,  15735,  16170,  16594,  17008,  17413,  17809,
+   18195,  18572,  18941,  19301,  19653,  19996,  20332,  20660,
+   20980,  21293,  21598,  21897,  22188,  22473,  22751,  23023,
+   23289,  23548,  23801,  24049,  24290,  24527,  24757,  24983,
+   25203,  25418,  25628,  25833,  26033,  26229,  26420,  26607,
+   26789,  26968,  27142,  27312,  27478,  27640,  27799,  27954,
+   28105,  28253,  28397,  28538,  28676,  28810,  28942,  29070,
+   29196,  29318,  29438,  29555,  29669,  29780,  29889,  29996,
+   30100,  30201,  30300,  30397,  30492,  30585,  30675,  30763,
+   30849,  30933,  31016,  31096,  31175,  31251,  31326,  31399,
+   31471,  31540,  31609,  31675,  31740,  31804,  31866,  31927,
+   31986,  32044,  32100,  32155,  32209,  32262,  32314,  32364,
+   32413,  32461,  32508,  32554,  32598,  32642,  32685,  32726,
+   32767
+};
+
+
+const PROGMEM int16_t shapeCurveFold[SHAPE_TABLE_SIZE] =
+{
+  -10126, -10811, -11492, -12167, -12836, -13499, -14155, -14804,
+  -15446, -16081, -16707, -17326, -17936, -18537, -19130, -19713,
+  -20286, -20849, -21403, -21945, -22477, -22999, -23508, -24007,
+  -24494, -24968, -25431, -25881, -26319, -26743, -27155, -27553,
+  -27938, -28310, -28667, -29011, -29340, -29655, -29956, -30242,
+  -30513, -30769, -31011, -31237, -31448, -31644, -31824, -31988,
+  -32137, -32271, -32388, -32490, -32576, -32646, -32700, -32738,
+  -32761, -32767, -32757, -32731, -32690, -32632, -32558, -32469,
+  -32364, -32242, -32106, -31953, -31785, -31601, -31402, -31188,
+  -30958, -30714, -30454, -30180, -29890, -29587, -29268, -28936,
+  -28589, -28228, -27854, -27466, -27065, -26650, -26223, -25782,
+  -25329, -24864, -24386, -23897, -23396, -22884, -22360, -21826,
+  -21280, -20725, -20159, -19584, -18999, -18404, -17801, -17189,
+  -16569, -15940, -15304, -14661, -14010, -13352, -12688, -12017,
+  -11341, -10659,  -9972,  -9281,  -8584,  -7884,  -7179,  -6471,
+   -5760,  -5046,  -4330,  -3612,  -2891,  -2170,  -1447,   -724,
+       0,    724,   1447,   2170,   2891,   3612,   4330,   5046,
+    5760,   6471,   7179,   7884,   8584,   9281,   9972,  10659,
+   11341,  12017,  12688,  13352,  14010,  14661,  15304,  15940,
+   16569,  17189,  17801,  18404,  18999,  19584,  20159,  20725,
+   21280,  21826,  22360,  22884,  23396,  23897,  24386,  24864,
+   25329,  25782,  26223,  26650,  27065,  27466,  27854,  28228,
+   28589,  28936,  29268,  29587,  29890,  30180,  30454,  30714,
+   30958,  31188,  31402,  31601,  31785,  31953,  32106,  32242,
+   32364,  32469,  32558,  32632,  32690,  32731,  32757,  32767,
+   32761,  32738,  32700,  32646,  32576,  32490,  32388,  32271,
+   32137,  31988,  31824,  31644,  31448,  31237,  31011,  30769,
+   30513,  30242,  29956,  29655,  29340,  29011,  28667,  28310,
+   27938,  27553,  27155,  26743,  26319,  25881,  25431,  24968,
+   24494,  24007,  23508,  22999,  22477,  21945,  21403,  20849,
+   20286,  19713,  19130,  18537,  17936,  17326,  16707,  16081,
+   15446,  14804,  14155,  13499,  12836,  12167,  11492,  10811,
+   10126
+};
+
+
+// curve list, in the same order as the radio buttons on the screen
+const int16_t * const shapeCurves[NUM_SHAPE_CURVES] =
+{
+  shapeCurveSoft, shapeCurveHard, shapeCurveTube, shapeCurveFold
+};
+
+const PROGMEM char shapeCurveNames[NUM_SHAPE_CURVES][5] =
+{
+  "Soft", "Hard", "Tube", "Fold"
+};
+
+#endif
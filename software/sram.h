@@ -0,0 +1,48 @@
+/******************************************************
+   sram.h - how the external SRAM is shared
+
+   version 1.0   Oct 2026
+
+   The 23LC1024 SRAM on the audio shield holds 65536 16 bit
+   samples, 1.49 sec. Without the looper the delay has all
+   of it. With USE_LOOPER, the delay gets the first
+   SRAM_DELAY_MS and the looper the rest:
+
+     0                  SRAM_DELAY_SAMPLES            65535
+     |  delayExt1       |  looper1                        |
+
+   The delay library allocates from the start of the chip
+   in order of construction, so delayExt1 (patches.h) is
+   created with SRAM_DELAY_SAMPLES and the looper is given
+   the rest by address. Change SRAM_DELAY_MS to trade
+   delay time for loop time.
+
+ ******************************************************/
+
+#ifndef SRAM_H
+#define SRAM_H
+
+
+#define SRAM_SAMPLES        65536
+#define SRAM_CS_PIN         6
+
+#ifdef USE_LOOPER
+#define SRAM_DELAY_MS       500
+#else
+#define SRAM_DELAY_MS       1000
+#endif
+
+// longest delay time in ms, the delay library needs one
+// extra block
+#ifdef USE_LOOPER
+#define SRAM_DELAY_SAMPLES  ((uint32_t)(SRAM_DELAY_MS * AUDIO_SAMPLE_RATE_EXACT / 1000.0) + AUDIO_BLOCK_SAMPLES)
+#else
+#define SRAM_DELAY_SAMPLES  SRAM_SAMPLES
+#endif
+
+#define SRAM_LOOPER_BEGIN   SRAM_DELAY_SAMPLES
+#define SRAM_LOOPER_SAMPLES (SRAM_SAMPLES - SRAM_DELAY_SAMPLES)
+
+#define DELAY_MAX_MS        SRAM_DELAY_MS
+
+#endif
@@ -13,20 +13,33 @@
 #include "guiItems.h"
 
 
+// how long a clip warning stays up
+#define CLIP_WARNING_MS  2000
+
+
 
 
 void statusScreen(bool initScreen)
 {
-  uint8_t numStatusButtons = 8;
-  int16_t statusButtonsX = 20;
-  int16_t statusButtonsY[numStatusButtons] = {20, 45, 70, 95, 120, 145, 170, 195};
-  String statusLabels[numStatusButtons] = {"Compressor", "Reverb", "Equalizer", "Flanger", "Tremolo", "Wah-Wah", "Delayer", "Chorus"};
+  const uint8_t numStatusButtons = 9;
+
+  // two columns of buttons
+  int16_t statusButtonsX[numStatusButtons] = {20, 20, 20, 20, 20, 170, 170, 170, 170};
+  int16_t statusButtonsY[numStatusButtons] = {25, 65, 105, 145, 185, 25, 65, 105, 145};
+  String statusLabels[numStatusButtons] = {"Compressor", "Reverb", "Equalizer", "Flanger", "Tremolo", "Wah-Wah", "Delayer", "Chorus", "Waveshaper"};
   bool status[numStatusButtons];
 
+  // clip warning, in the empty slot of the right column
+  static uint32_t clipTime = 0;
+  static bool clipShown = false;
+  static uint8_t lastClipMask = 0;
+  uint8_t clipMask = clip1.clipMask();
+
   if (initScreen)
   {
     eraseScreen();
     drawTitle("Effects Status");
+    clipShown = false;
   }
 
   status[0] = compressor.getStatus();
@@ -37,11 +50,37 @@ void statusScreen(bool initScreen)
   status[5] = wahwah.getStatus();
   status[6] = delayer.getStatus();
   status[7] = chorus.getStatus();
+  status[8] = waveshaper.getStatus();
 
   for (uint8_t i = 0; i < numStatusButtons; i++)
   {
-    drawButton(statusButtonsX, statusButtonsY[i], status[i]);
-    drawLabel(statusButtonsX + 20, statusButtonsY[i] - 5, statusLabels[i], false);
+    drawButton(statusButtonsX[i], statusButtonsY[i], status[i]);
+    drawLabel(statusButtonsX[i] + 20, statusButtonsY[i] - 5, statusLabels[i], false);
+  }
+
+  if (clipMask)
+  {
+    clipTime = millis();
+
+    // show the last point in the chain that clipped
+    if (clipMask != lastClipMask || !clipShown || initScreen)
+    {
+      uint8_t n = 31 - __builtin_clz(clipMask);
+      tft.fillRect(150, 175, 165, 20, GUI_FILL_COLOR);
+      tft.setFont(Arial_14);
+      tft.setTextColor(ILI9341_RED);
+      tft.setCursor(150, 180);
+      tft.print("CLIP ");
+      tft.print(clipNames[n]);
+      clipShown = true;
+      lastClipMask = clipMask;
+    }
+  }
+  else if (clipShown && millis() - clipTime > CLIP_WARNING_MS)
+  {
+    tft.fillRect(150, 175, 165, 20, GUI_FILL_COLOR);
+    clipShown = false;
+    lastClipMask = 0;
   }
 }
 
@@ -0,0 +1,319 @@
+/******************************************************
+ *  strum.h - polyphonic tuner, all six strings from a strum
+ *  version 1.0   Oct 2026
+ *
+ *  Every 100 ms the last 0.74 sec captured by strum1
+ *  (analyze_strum.h) is Hann windowed and run through a
+ *  4096 point fixed point FFT, 1.35 Hz per bin. This is
+ *  done from the main loop, not the audio interrupt.
+ *
+ *  Each string is searched for within a semitone of its
+ *  note in the current tuning, using the harmonic product
+ *  spectrum (the fundamental times the 2nd & 3rd harmonics)
+ *  so one string's harmonics aren't mistaken for another
+ *  string. The frequency is then refined by interpolating
+ *  the peaks of the first 3 harmonics.
+ *
+ *  The six strings are shown side by side, each with a
+ *  +-50 cent scale and a marker, green when within
+ *  STRUM_IN_TUNE cents.
+ *
+ ******************************************************/
+
+#ifndef STRUM_H
+#define STRUM_H
+
+#include <arm_math.h>
+#include "guiItems.h"
+
+
+#define STRUM_FFT_SIZE   STRUM_SAMPLES
+
+// bins used, up to 1378 Hz covers the 3rd harmonic of high E
+#define STRUM_BINS       1024
+#define STRUM_HARMONICS  3
+
+// quietest peak (half scale samples) that will be analyzed
+#define STRUM_MIN_LEVEL  200
+
+// strings weaker than this fraction of the loudest aren't shown
+#define STRUM_MIN_RATIO  0.02
+
+#define STRUM_IN_TUNE    3
+
+
+
+class StrumTuner {
+  public:
+    StrumTuner();
+    void init();
+    void open();
+    void close();
+    void update(const uint8_t *strings);
+    void drawScreen(const uint8_t *strings);
+
+  private:
+    static const uint8_t analyzeMs = 100;
+
+    // string columns
+    static const int16_t columnX = 8;
+    static const int16_t columnWidth = 44;
+    static const int16_t columnSpacing = 52;
+    static const int16_t scaleY = 60;
+    static const int16_t scaleHeight = 100;
+    static const int16_t markerHeight = 6;
+
+    arm_cfft_radix4_instance_q15 fftInst;
+    int16_t fftBuffer[2 * STRUM_FFT_SIZE] __attribute__ ((aligned (4)));
+    float mag[STRUM_BINS];
+    float loudest;
+
+    bool active;
+    elapsedMillis analyzeTime;
+    int16_t markerY[NUM_STRINGS];
+
+    bool analyze();
+    float findString(float freq);
+    float peakPosition(uint16_t bin);
+    void drawString(uint8_t s, float freq, const uint8_t *strings);
+};
+
+
+
+StrumTuner :: StrumTuner()
+{
+  active = false;
+}
+
+
+
+// run after audio board is initialized
+void StrumTuner :: init()
+{
+  arm_cfft_radix4_init_q15(&fftInst, STRUM_FFT_SIZE, 0, 1);
+  strum1.enable(false);
+}
+
+
+
+void StrumTuner :: open()
+{
+  if (active)
+    return;
+
+  strum1.enable(true);
+  analyzeTime = 0;
+  active = true;
+}
+
+
+
+void StrumTuner :: close()
+{
+  if (!active)
+    return;
+
+  strum1.enable(false);
+  active = false;
+}
+
+
+
+// called on every pass of the main loop, analyzes every 100 ms
+void StrumTuner :: update(const uint8_t *strings)
+{
+  if (!active || analyzeTime < analyzeMs)
+    return;
+  analyzeTime = 0;
+
+  bool strummed = analyze();
+
+  for (uint8_t s = 0; s < NUM_STRINGS; s++)
+    drawString(s, strummed ? findString(noteToFreq(strings[s])) : 0, strings);
+}
+
+
+
+// window & FFT the captured audio, false if too quiet
+bool StrumTuner :: analyze()
+{
+  int16_t *samples = fftBuffer;
+  strum1.read(samples);
+
+  int32_t sum = 0;
+  int16_t peak = 0;
+  for (uint16_t i = 0; i < STRUM_FFT_SIZE; i++)
+  {
+    sum += samples[i];
+    if (abs(samples[i]) > peak)
+      peak = abs(samples[i]);
+  }
+  if (peak < STRUM_MIN_LEVEL)
+    return false;
+
+  // remove dc & scale to full range, then window & spread out
+  // into complex pairs from the end down, in place
+  int16_t mean = sum / STRUM_FFT_SIZE;
+  float gain = 32000.0 / (peak + abs(mean));
+  float c = cosf(2.0 * PI / STRUM_FFT_SIZE);
+  float s = sinf(2.0 * PI / STRUM_FFT_SIZE);
+  float wCos = 1.0;
+  float wSin = 0;
+
+  for (int16_t i = STRUM_FFT_SIZE - 1; i >= 0; i--)
+  {
+    // Hann window is symmetric, so it can run backwards
+    float w = 0.5 - 0.5 * wCos;
+    float t = wCos * c - wSin * s;
+    wSin = wSin * c + wCos * s;
+    wCos = t;
+
+    fftBuffer[2 * i] = (int16_t)((samples[i] - mean) * gain * w);
+    fftBuffer[2 * i + 1] = 0;
+  }
+
+  arm_cfft_radix4_q15(&fftInst, fftBuffer);
+
+  loudest = 0;
+  for (uint16_t k = 0; k < STRUM_BINS; k++)
+  {
+    float re = fftBuffer[2 * k];
+    float im = fftBuffer[2 * k + 1];
+    mag[k] = sqrtf(re * re + im * im);
+    if (k > 1)
+      loudest = max(loudest, mag[k]);
+  }
+  return true;
+}
+
+
+
+// strongest harmonic product within a semitone of the string,
+// returns the frequency or 0 if not found
+float StrumTuner :: findString(float freq)
+{
+  const float binHz = PITCH_SAMPLE_RATE / STRUM_FFT_SIZE;
+  uint16_t lo = (uint16_t)(freq / 1.0594631 / binHz);
+  uint16_t hi = (uint16_t)(freq * 1.0594631 / binHz) + 1;
+  hi = min(hi, (uint16_t)(STRUM_BINS / STRUM_HARMONICS - 1));
+
+  float best = 0;
+  uint16_t bestBin = 0;
+
+  for (uint16_t k = lo; k <= hi; k++)
+  {
+    float product = mag[k];
+    for (uint8_t h = 2; h <= STRUM_HARMONICS; h++)
+      product *= mag[h * k];
+    if (product > best)
+    {
+      best = product;
+      bestBin = k;
+    }
+  }
+  if (bestBin == 0 || mag[bestBin] < loudest * STRUM_MIN_RATIO)
+    return 0;
+
+  // each harmonic's peak gives an estimate, weighted by its level
+  float total = 0;
+  float weights = 0;
+  for (uint8_t h = 1; h <= STRUM_HARMONICS; h++)
+  {
+    uint16_t k = h * bestBin;
+
+    // the harmonic may be a bin either side
+    if (mag[k - 1] > mag[k])
+      k--;
+    else if (mag[k + 1] > mag[k])
+      k++;
+
+    total += peakPosition(k) / h * mag[k];
+    weights += mag[k];
+  }
+  return total / weights * binHz;
+}
+
+
+
+// parabolic interpolation on the log magnitudes around a peak
+float StrumTuner :: peakPosition(uint16_t bin)
+{
+  if (bin < 1 || bin >= STRUM_BINS - 1)
+    return bin;
+
+  float a = logf(mag[bin - 1] + 1.0);
+  float b = logf(mag[bin] + 1.0);
+  float c = logf(mag[bin + 1] + 1.0);
+  float denom = a - 2.0 * b + c;
+  if (denom == 0)
+    return bin;
+  return bin + 0.5 * (a - c) / denom;
+}
+
+
+
+void StrumTuner :: drawScreen(const uint8_t *strings)
+{
+  tft.fillRect(0, 30, LCD_WIDTH, 175, GUI_FILL_COLOR);
+  tft.setFont(Arial_12);
+
+  for (uint8_t s = 0; s < NUM_STRINGS; s++)
+  {
+    int16_t x = columnX + s * columnSpacing;
+    uint8_t note = strings[s];
+
+    tft.setTextColor(GUI_TEXT_COLOR);
+    tft.setCursor(x + 8, 38);
+    tft.print(noteNames[note % 12]);
+    tft.print(note / 12 - 1);
+
+    tft.drawRect(x, scaleY, columnWidth, scaleHeight, GUI_SHAPE_COLOR);
+    tft.drawFastHLine(x, scaleY + scaleHeight / 2, columnWidth, GUI_TEXT_COLOR);
+    markerY[s] = -1;
+  }
+}
+
+
+
+// moves the marker & updates the cents, freq 0 = not found
+void StrumTuner :: drawString(uint8_t s, float freq, const uint8_t *strings)
+{
+  int16_t x = columnX + s * columnSpacing;
+  int16_t y = -1;
+  float cents = 0;
+  uint16_t color = ILI9341_RED;
+
+  if (freq > 0)
+  {
+    cents = 1200.0 * log2f(freq / noteToFreq(strings[s]));
+    y = scaleY + scaleHeight / 2 - (int16_t)(cents * scaleHeight / 100.0);
+    y = constrain(y, scaleY + 1, scaleY + scaleHeight - markerHeight - 1);
+    if (fabsf(cents) <= STRUM_IN_TUNE)
+      color = ILI9341_GREEN;
+    else if (fabsf(cents) <= 15)
+      color = ILI9341_YELLOW;
+  }
+
+  // erase the old marker & put back the centre line under it
+  if (markerY[s] >= 0)
+  {
+    tft.fillRect(x + 1, markerY[s], columnWidth - 2, markerHeight, GUI_FILL_COLOR);
+    tft.drawFastHLine(x, scaleY + scaleHeight / 2, columnWidth, GUI_TEXT_COLOR);
+  }
+  if (y >= 0)
+    tft.fillRect(x + 1, y, columnWidth - 2, markerHeight, color);
+  markerY[s] = y;
+
+  tft.fillRect(x, scaleY + scaleHeight + 4, columnWidth, 16, GUI_FILL_COLOR);
+  if (y >= 0)
+  {
+    tft.setFont(Arial_9);
+    tft.setTextColor(color);
+    tft.setCursor(x + 4, scaleY + scaleHeight + 6);
+    if (cents >= 0)
+      tft.print("+");
+    tft.print(cents, 1);
+  }
+}
+
+#endif
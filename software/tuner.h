@@ -1,142 +1,652 @@
 /******************************************************
  *  Tuner. h - code to implement the Guitar Tuner
- *  version 1.3.2   Sept 2020
- * 
+ *  version 2.0   Oct 2026
+ *
  *  Based on Teensy Digital Guitar Amplifier / Effects Processor
  *  by Brian Miller Circuit Cellar July 2017
- * 
- * 
+ *
+ *  Pitch is detected by pitch1 (analyze_pitch.h), the
+ *  note and cents are calculated from the frequency.
+ *
+ *  The tuner is a screen like the others, opened and closed
+ *  with the tuner button. The effects keep running while
+ *  tuning, and the buttons, pots & serial commands still
+ *  work. update() is called on every pass of the main loop
+ *  to collect the readings, the screen is redrawn 10 times
+ *  a second.
+ *
+ *  The param encoder selects the tuning, the reference pitch,
+ *  the view or the mute, the value encoder changes it. These
+ *  are saved with the config.
+ *
+ *    tuning     chromatic, or one of the alternate tunings,
+ *               where the nearest string is shown
+ *    reference  A4 from 430 to 450 Hz
+ *    view       bar graph, strobe, or all six strings at
+ *               once from a strum (strum.h)
+ *    mute       mutes the outputs while tuning
+ *
+ *  Once a note is found it becomes pitch1's target, and the
+ *  cents are measured from the phase drift against it, to a
+ *  fraction of a cent. The strobe stripes are drawn at that
+ *  phase, so they stand still when in tune and move right
+ *  when sharp, left when flat. animate() redraws the strobe
+ *  at 40 frames a second, only the slivers at the edges of
+ *  the stripes that moved are drawn.
+ *
  ******************************************************/
 
+#ifndef TUNER_H
+#define TUNER_H
+
 
 #include "guiItems.h"
 
 
 
-extern Bounce tunerSwitch;
 extern ILI9341_t3 tft;
 
 
-const PROGMEM float NoteFreq[35] =
+// reference pitch range for A4
+#define TUNER_REF_MIN  430
+#define TUNER_REF_MAX  450
+
+#define NUM_MIDI_NOTES 128
+#define NUM_STRINGS    6
+
+// tuner views
+#define TUNER_BAR       0
+#define TUNER_STROBE    1
+#define TUNER_STRUM     2
+#define NUM_TUNER_VIEWS 3
+
+
+const char *noteNames[12] =
+{
+  "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
+};
+
+
+
+// frequency of every midi note at A4 = 440 Hz, built by the
+// compiler stepping a semitone at a time up & down from A4
+struct NoteTable
+{
+  float freq[NUM_MIDI_NOTES];
+};
+
+constexpr NoteTable makeNoteTable()
+{
+  const double semitone = 1.0594630943592953;   // 2^(1/12)
+  NoteTable t = {};
+  double f = 440.0;
+
+  for (int16_t n = 69; n < NUM_MIDI_NOTES; n++, f *= semitone)
+    t.freq[n] = f;
+
+  f = 440.0 / semitone;
+  for (int16_t n = 68; n >= 0; n--, f /= semitone)
+    t.freq[n] = f;
+
+  return t;
+}
+
+constexpr NoteTable noteTable = makeNoteTable();
+
+
+
+// string notes, low E to high E, as midi notes. Chromatic
+// has no strings, the nearest note is shown
+struct Tuning
+{
+  const char *name;
+  uint8_t strings[NUM_STRINGS];
+};
+
+const Tuning tunings[] =
 {
-  61.714,  65.385,  69.268,  73.425,  82.410,
-  87.273,  92.500,  98.000,  103.784, 110.000,
-  116.522, 123.249, 130.769, 138.537, 146.830,
-  155.556, 164.800, 174.545, 185.000, 196.000,
-  207.568, 220.000, 233.043, 246.940, 261.538,
-  277.073, 293.699, 311.111, 329.630, 349.091,
-  370.000, 392.000, 415.135, 440.000, 466.087
+  {"Chromatic",  { 0,  0,  0,  0,  0,  0}},
+  {"Standard",   {40, 45, 50, 55, 59, 64}},
+  {"Drop D",     {38, 45, 50, 55, 59, 64}},
+  {"DADGAD",     {38, 45, 50, 55, 57, 62}},
+  {"Half Down",  {39, 44, 49, 54, 58, 63}}
 };
 
+#define NUM_TUNINGS (sizeof(tunings) / sizeof(tunings[0]))
+
+
+
+// frequency as a (fractional) midi note number
+float freqToNote(float freq)
+{
+  return 12.0 * log2f(freq / cfg.tunerRef) + 69.0;
+}
+
 
-const PROGMEM char NoteName[36][4] =
+
+// frequency of a midi note at the current reference pitch
+float noteToFreq(uint8_t note)
 {
-  "C2 ", "C#2", "D2 ", "D#2", "E2 ",
-  "F2 ", "F#2", "G2 ", "G#2", "A2 ",
-  "A#2", "B2 ", "C3 ", "C#3", "D3 ",
-  "D#3", "E3 ", "F3 ", "F#3", "G3 ",
-  "G#3", "A3 ", "A#3", "B3 ", "C4 ",
-  "C#4", "D4 ", "D#4", "E4 ", "F4 ",
-  "F#4", "G4 ", "G#4", "A4 ", "A#4",
-  "B4 "
+  return noteTable.freq[note % NUM_MIDI_NOTES] * cfg.tunerRef / 440.0;
+}
+
+
+
+
+// polyphonic tuner, uses the note tables above
+#include "strum.h"
+
+
+
+class Tuner {
+  public:
+    Tuner();
+    void init();
+    void open();
+    void close();
+    void update();
+    void process(bool);
+    void animate();
+    void applySettings();
+    void printConfig();
+    bool active;
+
+  private:
+    static const uint8_t displayMs = 100;
+    static const uint8_t numItems = 4;
+    enum {TUNING, REFERENCE, VIEW, MUTE};
+    uint8_t selectedItem;
+
+    // bar graph & strobe area, strobe stripes & frame rate
+    static const int16_t meterY = 40;
+    static const int16_t meterHeight = 50;
+    static const int16_t stripePeriod = 32;
+    static const uint8_t frameMs = 25;
+
+    StrumTuner strum;
+
+    float targetFreq;
+    int16_t strobeOffset;
+    elapsedMillis frameTime;
+
+    // readings averaged since the last display
+    float noteSum;
+    uint8_t noteCount;
+
+    int16_t lastNote;
+    int16_t lastGraphic;
+    elapsedMillis displayTime;
+
+    void setMute(bool mute);
+    void startView();
+    const uint8_t *strumStrings();
+    void checkEncoders();
+    void drawScreen();
+    void drawSettings();
+    void drawReading(float note);
+    void drawStrobe(bool drawAll);
+    void fillStripe(int16_t x, int16_t w, uint16_t color);
 };
 
 
 
+Tuner :: Tuner()
+{
+  active = false;
+  selectedItem = TUNING;
+  noteSum = 0;
+  noteCount = 0;
+}
+
+
+
+// run after audio board is initialized
+void Tuner :: init()
+{
+  pitch1.enable(false);
+  strum.init();
+  printValue("Tuner initialized");
+}
+
+
+
+// start the pitch detector, mute if selected
+void Tuner :: open()
+{
+  if (active)
+    return;
+
+  memProfileSample();
+  noteSum = 0;
+  noteCount = 0;
+  targetFreq = 0;
+  pitch1.setTarget(0);
+  startView();
+  setMute(cfg.tunerMute);
+  active = true;
+  printValue("Tuner on");
+}
+
+
+
+// called when leaving the screen
+void Tuner :: close()
+{
+  if (!active)
+    return;
+
+  memProfileSample();
+  pitch1.enable(false);
+  strum.close();
+  setMute(false);
+  active = false;
+  printValue("Tuner off");
+}
+
+
+
+void Tuner :: setMute(bool mute)
+{
+  if (mute)
+  {
+    audioShield.muteHeadphone();
+    audioShield.muteLineout();
+  }
+  else
+  {
+    audioShield.unmuteHeadphone();
+    audioShield.unmuteLineout();
+  }
+}
+
+
+
+// settings changed from the console or serial protocol.
+// While open, switch the analyzer for the view & the mute,
+// the screen is redrawn by the main loop (params.h). Closed,
+// they're used next time it's opened
+void Tuner :: applySettings()
+{
+  if (!active)
+    return;
+
+  memProfileSample();
+  startView();
+  setMute(cfg.tunerMute);
+  noteSum = 0;
+  noteCount = 0;
+  lastNote = -1;
+}
+
+
+
+// run the analyzer for the view, the strum tuner
+// replaces the pitch detector
+void Tuner :: startView()
+{
+  if (cfg.tunerView == TUNER_STRUM)
+  {
+    pitch1.enable(false);
+    strum.open();
+  }
+  else
+  {
+    strum.close();
+    pitch1.enable(true);
+  }
+}
+
+
+
+// strings for the strum tuner, standard tuning if chromatic
+const uint8_t *Tuner :: strumStrings()
+{
+  return tunings[cfg.tuning == 0 ? 1 : cfg.tuning].strings;
+}
+
+
+
+// collect readings, called on every pass of the main loop
+void Tuner :: update()
+{
+  if (!active)
+    return;
+
+  // strum analysis is throttled to every 100 ms
+  if (cfg.tunerView == TUNER_STRUM)
+  {
+    strum.update(strumStrings());
+    return;
+  }
+
+  if (!pitch1.available())
+    return;
+
+  float note = freqToNote(pitch1.read());
+
+  // start over if the note changed
+  if (noteCount > 0 && fabsf(note - noteSum / noteCount) > 0.5)
+  {
+    noteSum = 0;
+    noteCount = 0;
+  }
+  noteSum += note;
+  noteCount++;
+}
+
+
 
-void guitarTuner()
+void Tuner :: process(bool initScreen)
 {
-  float abs_delta, delta, note,  minimum_Delta, minimum_abs_Delta, higher_Note, lower_Note, cents;
-  String note_String, last_Note_String;
-  uint16_t cents_Graphic;
+  if (initScreen)
+  {
+    open();
+    drawScreen();
+
+    // don't count an old encoder position as a turn
+    lastParamEncVal = readParamEncoder() / 2;
+    lastValEncVal = readValueEncoder() / 2;
+  }
+
+  checkEncoders();
+
+  // throttle the display
+  if (noteCount == 0 || displayTime < displayMs)
+    return;
+  displayTime = 0;
 
-  higher_Note = 0;
-  lower_Note = 0;
-  minimum_Delta = 0;
-  printValue("Guitar Tuna");
+  drawReading(noteSum / noteCount);
+  noteSum = 0;
+  noteCount = 0;
+}
 
-  tft.fillScreen(GUI_FILL_COLOR);
-  tft.setFont(Arial_32);
-  tft.setCursor(30, 0);
-  tft.print("Guitar Tuna");
-  tft.setFont(Arial_60);
-  tft.setTextColor(ILI9341_WHITE);
 
-  // may halt until a freq is detected
-  notefreq1.begin(0.15);
-  delay(100);
 
-  bool tuningMode = true;
-  while (tuningMode)
+void Tuner :: printConfig()
+{
+  Serial.print(F("Tuner Tuning = ")); Serial.println(tunings[cfg.tuning].name);
+  Serial.print(F("Tuner Ref    = ")); Serial.println(cfg.tunerRef);
+  Serial.print(F("Tuner View   = ")); Serial.println(cfg.tunerView);
+  Serial.print(F("Tuner Mute   = ")); Serial.println(cfg.tunerMute);
+
+  if (cfg.tuning == 0)
+    return;
+
+  for (uint8_t s = 0; s < NUM_STRINGS; s++)
+  {
+    uint8_t note = tunings[cfg.tuning].strings[s];
+    Serial.print(F("  String ")); Serial.print(NUM_STRINGS - s);
+    Serial.print(F(" = ")); Serial.print(noteNames[note % 12]); Serial.print(note / 12 - 1);
+    Serial.print(F("  ")); Serial.print(noteToFreq(note)); Serial.println(F(" Hz"));
+  }
+}
+
+
+
+// param encoder selects the setting, value encoder changes it
+void Tuner :: checkEncoders()
+{
+  paramEncVal = readParamEncoder() / 2;
+  valEncVal = readValueEncoder() / 2;
+
+  if (paramEncVal != lastParamEncVal)
+  {
+    if (paramEncVal > lastParamEncVal)
+      selectedItem = (selectedItem + 1) % numItems;
+    else
+      selectedItem = (selectedItem + numItems - 1) % numItems;
+    drawSettings();
+  }
+  else if (valEncVal != lastValEncVal)
   {
-    if (notefreq1.available())
+    int8_t step = (valEncVal > lastValEncVal) ? 1 : -1;
+
+    switch (selectedItem)
     {
-      minimum_abs_Delta = 9999;
-      note = notefreq1.read();
+      case TUNING:
+        cfg.tuning = (cfg.tuning + NUM_TUNINGS + step) % NUM_TUNINGS;
+        if (cfg.tunerView == TUNER_STRUM)
+          strum.drawScreen(strumStrings());
+        break;
 
-      printValue("freq", note);
+      case REFERENCE:
+        cfg.tunerRef = constrain(cfg.tunerRef + step, TUNER_REF_MIN, TUNER_REF_MAX);
+        break;
 
-      for (int i = 0; i < 35; i++)
-      {
-        delta = note - NoteFreq[i];
-        abs_delta = abs(delta);
-        if (abs_delta < minimum_abs_Delta)
-        {
-          minimum_abs_Delta = abs_delta;
-          minimum_Delta = delta;
-          note_String = String(NoteName[i]);
-          if (delta > 0)
-          {
-            higher_Note = NoteFreq[i + 1];
-            lower_Note = NoteFreq[i];
-          }
-          else
-          {
-            higher_Note = NoteFreq[i];
-            lower_Note = NoteFreq[i - 1];
-          }
-        }
-      }
+      case VIEW:
+        cfg.tunerView = (cfg.tunerView + NUM_TUNER_VIEWS + step) % NUM_TUNER_VIEWS;
+        startView();
+        drawScreen();
+        break;
+
+      case MUTE:
+        cfg.tunerMute = !cfg.tunerMute;
+        setMute(cfg.tunerMute);
+        break;
+    }
+    drawSettings();
 
-      if (minimum_Delta > 0)
-        cents = (int)(100 * (note - lower_Note) / (higher_Note - lower_Note));
-      else
-        cents = (int)(100 * ( note - higher_Note) / (higher_Note - lower_Note));
+    // force the note to be redrawn
+    lastNote = -1;
+  }
+
+  lastParamEncVal = paramEncVal;
+  lastValEncVal = valEncVal;
+}
+
+
+
+void Tuner :: drawScreen()
+{
+  eraseScreen();
+  drawTitle("Tuner");
+  drawSettings();
 
-      // transpose +-50 cents to 0-320 X co-ordinates
-      cents_Graphic = (uint16_t)((50.0 + cents) * 3.2);
-      cents_Graphic = constrain(cents_Graphic, 4, 315);
+  lastNote = -1;
+  lastGraphic = -1;
+  if (cfg.tunerView == TUNER_STROBE)
+    drawStrobe(true);
+  else if (cfg.tunerView == TUNER_STRUM)
+    strum.drawScreen(strumStrings());
+}
+
+
+
+// settings across the top, selected one highlighted
+void Tuner :: drawSettings()
+{
+  const int16_t itemX[numItems] = {5, 110, 190, 260};
+  const char *viewNames[NUM_TUNER_VIEWS] = {"Bar", "Strobe", "Strum"};
+
+  tft.fillRect(0, 5, LCD_WIDTH, 20, GUI_FILL_COLOR);
+  tft.setFont(Arial_12);
+
+  for (uint8_t i = 0; i < numItems; i++)
+  {
+    tft.setTextColor(i == selectedItem ? GUI_FOCUS_ITEM_COLOR : GUI_ITEM_COLOR);
+    tft.setCursor(itemX[i], 5);
+
+    if (i == TUNING)
+      tft.print(tunings[cfg.tuning].name);
+    else if (i == REFERENCE)
+    {
+      tft.print("A = ");
+      tft.print((int)cfg.tunerRef);
+    }
+    else if (i == VIEW)
+      tft.print(viewNames[cfg.tunerView]);
+    else
+      tft.print(cfg.tunerMute ? "Muted" : "Live");
+  }
+}
 
-      // draw background bar graph
-      tft.fillRect(  0, 50, 64, 50, ILI9341_RED);
-      tft.fillRect( 64, 50, 80, 50, ILI9341_YELLOW);
-      tft.fillRect(144, 50, 32, 50, ILI9341_GREEN);
-      tft.fillRect(176, 50, 80, 50, ILI9341_YELLOW);
-      tft.fillRect(256, 50, 63, 50, ILI9341_RED);
 
-      // highlight the tuning in black
-      tft.fillRect(cents_Graphic - 4, 50, 8, 50, ILI9341_BLACK);
 
-      // display the note and octave in large font
-      if (note_String != last_Note_String)
+void Tuner :: drawReading(float note)
+{
+  int16_t nearest = (int16_t)roundf(note);
+  int8_t string = -1;
+
+  // with a tuning selected, the target is the nearest string
+  if (cfg.tuning != 0)
+  {
+    const uint8_t *strings = tunings[cfg.tuning].strings;
+    float closest = 999;
+    for (uint8_t s = 0; s < NUM_STRINGS; s++)
+    {
+      if (fabsf(note - strings[s]) < closest)
       {
-        tft.fillRect(99, 149, 160, 80, ILI9341_BLACK);
-        tft.setCursor(100, 150);
-        tft.print(note_String);
-        last_Note_String = note_String;
+        closest = fabsf(note - strings[s]);
+        nearest = strings[s];
+        string = s;
       }
-      delay(150);   // display around 5 readings per sec
     }
+  }
+  nearest = constrain(nearest, 0, NUM_MIDI_NOTES - 1);
+  float cents = (note - nearest) * 100.0;
+
+  // new note, measure the phase against it. Otherwise use the
+  // phase drift for the cents if there is any
+  if (nearest != lastNote)
+  {
+    targetFreq = noteToFreq(nearest);
+    pitch1.setTarget(targetFreq);
+  }
+  else if (pitch1.offsetAvailable())
+  {
+    float offset = pitch1.readOffset();
+    cents = 1200.0 * log2f((targetFreq + offset) / targetFreq);
+  }
+
+  printValue("cents", cents);
+
+  // transpose +-50 cents to 0-320 X co-ordinates
+  int16_t cents_Graphic = (int16_t)((50.0 + cents) * 3.2);
+  cents_Graphic = constrain(cents_Graphic, 4, 315);
 
-    // if tuner switch is pressed again, exit
-    tunerSwitch.update();
-    if (tunerSwitch.fallingEdge())
+  if (cfg.tunerView == TUNER_BAR && cents_Graphic != lastGraphic)
+  {
+    // draw background bar graph
+    tft.fillRect(  0, 40, 64, 50, ILI9341_RED);
+    tft.fillRect( 64, 40, 80, 50, ILI9341_YELLOW);
+    tft.fillRect(144, 40, 32, 50, ILI9341_GREEN);
+    tft.fillRect(176, 40, 80, 50, ILI9341_YELLOW);
+    tft.fillRect(256, 40, 63, 50, ILI9341_RED);
+
+    // highlight the tuning in black
+    tft.fillRect(cents_Graphic - 4, 40, 8, 50, ILI9341_BLACK);
+    lastGraphic = cents_Graphic;
+  }
+
+  // display the note and octave in large font, with the
+  // string & target frequency
+  if (nearest != lastNote)
+  {
+    tft.fillRect(99, 109, 160, 80, ILI9341_BLACK);
+    tft.setFont(Arial_60);
+    tft.setTextColor(ILI9341_WHITE);
+    tft.setCursor(100, 110);
+    tft.print(noteNames[nearest % 12]);
+    tft.print(nearest / 12 - 1);
+
+    tft.fillRect(5, 180, 310, 20, GUI_FILL_COLOR);
+    tft.setFont(Arial_12);
+    tft.setTextColor(GUI_TEXT_COLOR);
+    tft.setCursor(5, 185);
+    if (string >= 0)
     {
-      printValue("Exiting Tuner");
-      tuningMode = false;
+      tft.print("String ");
+      tft.print(NUM_STRINGS - string);
     }
+    tft.setCursor(230, 185);
+    tft.print(noteToFreq(nearest), 1);
+    tft.print(" Hz");
+    lastNote = nearest;
+  }
+
+  // cents to a tenth
+  tft.fillRect(110, 180, 100, 20, GUI_FILL_COLOR);
+  tft.setFont(Arial_12);
+  tft.setTextColor(GUI_TEXT_COLOR);
+  tft.setCursor(120, 185);
+  if (cents >= 0)
+    tft.print("+");
+  tft.print(cents, 1);
+  tft.print(" cents");
+}
+
+
+
+// redraw the strobe, called while the main loop is waiting
+void Tuner :: animate()
+{
+  if (!active || cfg.tunerView != TUNER_STROBE || frameTime < frameMs)
+    return;
+  frameTime = 0;
+
+  dropout1.activityStart(ACT_SCREEN);
+  drawStrobe(false);
+  dropout1.activityEnd(ACT_SCREEN);
+}
+
+
+
+// stripes offset by the phase, a stripe period is one cycle.
+// Only the edges that moved are redrawn
+void Tuner :: drawStrobe(bool drawAll)
+{
+  const int16_t half = stripePeriod / 2;
+  int16_t offset = (int16_t)((pitch1.readPhase() + PI) * stripePeriod / (2.0 * PI)) % stripePeriod;
+
+  if (drawAll)
+  {
+    tft.fillRect(0, meterY, LCD_WIDTH, meterHeight, GUI_FILL_COLOR);
+    for (int16_t x = offset - stripePeriod; x < LCD_WIDTH; x += stripePeriod)
+      fillStripe(x, half, ILI9341_WHITE);
+    strobeOffset = offset;
+    return;
+  }
+
+  // shortest way round to the new offset
+  int16_t move = offset - strobeOffset;
+  if (move > half)
+    move -= stripePeriod;
+  else if (move < -half)
+    move += stripePeriod;
+  if (move == 0)
+    return;
+
+  for (int16_t x = strobeOffset - stripePeriod; x < LCD_WIDTH + stripePeriod; x += stripePeriod)
+  {
+    if (move > 0)
+    {
+      // moving right, white grows at the right edge
+      fillStripe(x + half, move, ILI9341_WHITE);
+      fillStripe(x, move, GUI_FILL_COLOR);
+    }
+    else
+    {
+      fillStripe(x + move, -move, ILI9341_WHITE);
+      fillStripe(x + half + move, -move, GUI_FILL_COLOR);
+    }
+  }
+  strobeOffset = offset;
+}
+
+
+
+// vertical strip of the strobe, clipped to the screen
+void Tuner :: fillStripe(int16_t x, int16_t w, uint16_t color)
+{
+  if (x < 0)
+  {
+    w += x;
+    x = 0;
   }
+  if (x + w > LCD_WIDTH)
+    w = LCD_WIDTH - x;
+  if (w > 0)
+    tft.fillRect(x, meterY, w, meterHeight, color);
+}
 
-  // shut off notefreq1 processing
-  notefreq1.begin(-1.0);
- }
+#endif
@@ -20,6 +20,26 @@
 
 
 
+// the sine generator only sends audio when its amplitude is
+// non-zero, so turn it off at the source rather than just
+// muting the mixer. Otherwise mixer1 sends a block every
+// update and none of the effects can skip silent blocks.
+void testTone(bool on)
+{
+  if (on)
+  {
+    sine2.amplitude(0.5);   // 50% amplitude
+    mixer1.gain(TEST_TONE, AUDIO_ON);
+  }
+  else
+  {
+    sine2.amplitude(0);
+    mixer1.gain(TEST_TONE, AUDIO_OFF);
+  }
+}
+
+
+
 void updateMix(int pot)
 {
   // Wet starts at 0 & goes to 100% (fully cw)
@@ -31,6 +51,11 @@ void updateMix(int pot)
 
   mixer4.gain(DRY_OUT, dryLevel);
   mixer4.gain(WET_OUT, wetLevel);
+#ifdef USE_LOOPER
+  // the looper records the same mix
+  mixer6.gain(DRY_OUT, dryLevel);
+  mixer6.gain(WET_OUT, wetLevel);
+#endif
 
   printValue("dry", dryLevel);
   printValue("wet", wetLevel);
@@ -52,7 +77,7 @@ void updateAudio()
 {
   // input mixer 1 standard settings
   mixer1.gain(LEFT_IN, AUDIO_ON);     // left channel input
-  mixer1.gain(TEST_TONE, AUDIO_OFF);  // test tone input
+  testTone(false);
 
   // delay input
   mixer5.gain(DELAY_DRY_IN, 1.0);
@@ -65,5 +90,7 @@ void updateAudio()
   delayer.update();
   tremolo.update();
   flanger.update();
+  waveshaper.update();
+  noiseGate.update();
   levels.update();
 }
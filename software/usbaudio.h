@@ -0,0 +1,142 @@
+/**********************************************************
+   USB Audio Interface
+
+   With USB Type set to 'Audio + Serial' (or 'Serial + MIDI
+   + Audio') the GEP is also a USB sound card:
+
+   - record: the processed output is sent to the PC on the
+     left channel. The right channel is the same, or the
+     dry input (after the input level) with usb.dry on, for
+     reamping later.
+   - reamp: with usb.reamp on, the left channel from the PC
+     replaces the guitar input, so a recorded DI track is
+     played through the whole chain, in time with the
+     recording.
+
+   Both are set with the console or the serial protocol
+   ("set usb.reamp 1") and are off at power up, so the
+   guitar input always works after a restart.
+
+   tools/reamp.py plays a WAV to the GEP and records what
+   comes back. tests/graph_run runs the same WAV thru a
+   simulation of the repo's own nodes on a PC, for an A/B.
+
+   Does nothing unless the USB type includes audio.
+
+   version 1.0   Oct 2026
+
+   Audio chain:
+   I2S1 --|-- Gate1 -> ... -> Biquad1 -> USB2 left
+   USB1 --|                         |--> USB2 right (wet)
+                             I2S1 ----> USB2 right (dry)
+
+ * **************************************************************/
+
+#ifndef USB_AUDIO_H
+#define USB_AUDIO_H
+
+#ifdef AUDIO_INTERFACE
+
+
+AudioInputUSB    usb1;
+AudioOutputUSB   usb2;
+
+// record taps, the right channel is switched between
+// wet & dry
+AudioConnection  usbWetCord(biquad1, 0, usb2, 0);
+AudioConnection  usbWetRightCord(biquad1, 0, usb2, 1);
+AudioConnection  usbDryCord(i2s1, 0, usb2, 1);
+
+// reamp source, replaces patchCord5 (i2s1 -> gate1)
+AudioConnection  usbReampCord(usb1, 0, gate1, 0);
+
+
+class UsbAudio {
+  public:
+    UsbAudio();
+    void init();
+    void update();
+    void printConfig();
+    bool dry;
+    bool reamp;
+
+  private:
+    bool dryConnected;
+    bool reampConnected;
+};
+
+
+
+UsbAudio :: UsbAudio()
+{
+  dry = false;
+  reamp = false;
+
+  // all cords connect when created
+  dryConnected = true;
+  reampConnected = true;
+}
+
+
+
+// run after audio board is initialized
+void UsbAudio :: init()
+{
+  dry = false;
+  reamp = false;
+  update();
+  printValue("USB Audio initialized");
+}
+
+
+
+// connect the cords to match dry & reamp, an input can
+// only have one source connected at a time
+void UsbAudio :: update()
+{
+  if (dry != dryConnected)
+  {
+    AudioNoInterrupts();
+    if (dry)
+    {
+      usbWetRightCord.disconnect();
+      usbDryCord.connect();
+    }
+    else
+    {
+      usbDryCord.disconnect();
+      usbWetRightCord.connect();
+    }
+    AudioInterrupts();
+    dryConnected = dry;
+  }
+
+  if (reamp != reampConnected)
+  {
+    AudioNoInterrupts();
+    if (reamp)
+    {
+      patchCord5.disconnect();
+      usbReampCord.connect();
+    }
+    else
+    {
+      usbReampCord.disconnect();
+      patchCord5.connect();
+    }
+    AudioInterrupts();
+    reampConnected = reamp;
+    printValue(reamp ? "Reamping from USB" : "Input from guitar");
+  }
+}
+
+
+
+void UsbAudio :: printConfig()
+{
+  Serial.print("USB Dry Right   = "); Serial.println(dry);
+  Serial.print("USB Reamp       = "); Serial.println(reamp);
+}
+
+#endif
+#endif
@@ -19,6 +19,8 @@ void printValue(const char*, int, float);
 void printHexValue(const char*, int);
 void printArryValue(const char* , uint8_t, float);
 void printAudioMemUsage();
+void idle();
+void idleDelay(uint32_t ms);
 
 
 
@@ -125,6 +127,25 @@ uint32_t teensyFreeMem()
 }
 
 
+// a delay that keeps idle() running (Teensy_GEP.ino), so the
+// pedal & anything else that has to be polled isn't missed
+// while a screen waits or shows a message. The wait isn't
+// drawing, so it isn't tagged as screen activity
+void idleDelay(uint32_t ms)
+{
+  bool drawing = dropout1.activities() & ACT_SCREEN;
+  dropout1.activityEnd(ACT_SCREEN);
+
+  elapsedMillis waitTime;
+  while (waitTime < ms)
+    idle();
+
+  if (drawing)
+    dropout1.activityStart(ACT_SCREEN);
+}
+
+
+
 void printAudioMemUsage()
 {
   Serial.println(F("CPU Usage"));
@@ -0,0 +1,260 @@
+/******************************************************
+   console_test.cpp - set / get / list lines (console.h)
+   with a stub param table, built & run on a PC
+
+     make -C tests test
+
+ ******************************************************/
+
+#include "Arduino.h"
+
+
+// a small param table in place of params.h
+#define PARAMS_H
+
+#define PARAM_FLOAT   0
+#define PARAM_UINT8   1
+
+struct Param
+{
+  const char *name;
+  uint8_t type;
+  void *value;
+  float minVal;
+  float maxVal;
+};
+
+float roomsize;
+float delayTimes[2];
+uint8_t inputLevel;
+uint8_t x;
+
+const Param params[] =
+{
+  {"reverb.roomsize",  PARAM_FLOAT, &roomsize,       0,   1.0},
+  {"delay.time[0]",    PARAM_FLOAT, &delayTimes[0],  0,   1000},
+  {"delay.time[1]",    PARAM_FLOAT, &delayTimes[1],  0,   1000},
+  {"input.level",      PARAM_UINT8, &inputLevel,     0,   15},
+
+  // short, to fit a lot in a line
+  {"x",                PARAM_UINT8, &x,              0,   15}
+};
+
+#define NUM_PARAMS (sizeof(params) / sizeof(params[0]))
+
+// each applyParams() call & how many it was given
+uint8_t applyCalls;
+uint8_t applyCount;
+
+
+int16_t findParam(const char *name)
+{
+  for (uint16_t i = 0; i < NUM_PARAMS; i++)
+  {
+    if (strcmp(params[i].name, name) == 0)
+      return i;
+  }
+  return -1;
+}
+
+float getParam(uint8_t id)
+{
+  if (params[id].type == PARAM_UINT8)
+    return *(uint8_t *)params[id].value;
+  return *(float *)params[id].value;
+}
+
+bool setParam(uint8_t id, float value, bool apply)
+{
+  value = constrain(value, params[id].minVal, params[id].maxVal);
+  if (params[id].type == PARAM_UINT8)
+    *(uint8_t *)params[id].value = (uint8_t)roundf(value);
+  else
+    *(float *)params[id].value = value;
+  return true;
+}
+
+void applyParams(const uint8_t *ids, uint8_t count)
+{
+  applyCalls++;
+  applyCount = count;
+}
+
+bool savePreset(uint8_t n)
+{
+  return n < 4;
+}
+
+bool loadPreset(uint8_t n)
+{
+  return n < 4;
+}
+
+
+#include "../software/console.h"
+
+
+
+int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+
+// runs a line, returns what was printed
+std::string run(const char *text, bool *handled = NULL)
+{
+  char line[CONSOLE_LINE_LENGTH + 1];
+  strncpy(line, text, CONSOLE_LINE_LENGTH);
+  line[CONSOLE_LINE_LENGTH] = 0;
+
+  Serial.out.clear();
+  bool ok = doLineCommand(line);
+  if (handled)
+    *handled = ok;
+  return Serial.out;
+}
+
+
+void reset()
+{
+  roomsize = 0.5;
+  delayTimes[0] = 0;
+  delayTimes[1] = 0;
+  inputLevel = 5;
+  x = 0;
+  applyCalls = 0;
+  applyCount = 0;
+}
+
+
+
+void testSplit()
+{
+  char line[] = "set  a 1\tb   2 ";
+  char *args[3];
+
+  // counts them all, keeps the first 3
+  CHECK(splitLine(line, args, 3) == 5);
+  CHECK(strcmp(args[0], "set") == 0);
+  CHECK(strcmp(args[2], "1") == 0);
+}
+
+
+void testSet()
+{
+  reset();
+  CHECK(run("set reverb.roomsize 0.6") == "reverb.roomsize = 0.600\r\n");
+  CHECK(roomsize == 0.6f);
+  CHECK(applyCalls == 1 && applyCount == 1);
+
+  // a batch is applied once
+  reset();
+  CHECK(run("set delay.time[0] 250 delay.time[1] 500") ==
+        "delay.time[0] = 250.000\r\ndelay.time[1] = 500.000\r\n");
+  CHECK(delayTimes[0] == 250 && delayTimes[1] == 500);
+  CHECK(applyCalls == 1 && applyCount == 2);
+
+  // constrained & rounded
+  reset();
+  CHECK(run("set input.level 20") == "input.level = 15\r\n");
+  CHECK(run("set input.level 2.6") == "input.level = 3\r\n");
+}
+
+
+void testSetErrors()
+{
+  // nothing is set if any of them is wrong
+  reset();
+  CHECK(run("set delay.time[0] 250 reverb.room 0.6") == "error: unknown param reverb.room\r\n");
+  CHECK(delayTimes[0] == 0 && applyCalls == 0);
+
+  CHECK(run("set delay.time[0] 250 delay.time[1] 5x") == "error: bad value 5x\r\n");
+  CHECK(delayTimes[0] == 0 && applyCalls == 0);
+
+  CHECK(run("set delay.time[0]") == "error: usage: set <param> <value> ...\r\n");
+  CHECK(run("set") == "error: usage: set <param> <value> ...\r\n");
+}
+
+
+void testTooMany()
+{
+  // 8 pairs is the most
+  reset();
+  std::string line = "set";
+  for (uint8_t i = 0; i < CONSOLE_MAX_ARGS / 2; i++)
+    line += " x 9";
+  run(line.c_str());
+  CHECK(x == 9 && applyCount == CONSOLE_MAX_ARGS / 2);
+
+  // one word more is refused, not cut short
+  reset();
+  line += " input.level 9";
+  bool handled;
+  CHECK(run(line.c_str(), &handled) == "error: too many params\r\n");
+  CHECK(handled);
+  CHECK(x == 0 && inputLevel == 5 && applyCalls == 0);
+
+  line = "get";
+  for (uint8_t i = 0; i <= CONSOLE_MAX_ARGS; i++)
+    line += " x";
+  CHECK(run(line.c_str()) == "error: too many params\r\n");
+}
+
+
+void testGet()
+{
+  reset();
+  CHECK(run("get input.level reverb.roomsize") == "input.level = 5\r\nreverb.roomsize = 0.500\r\n");
+
+  // the others are still printed
+  CHECK(run("get foo input.level") == "error: unknown param foo\r\ninput.level = 5\r\n");
+  CHECK(run("get") == "error: usage: get <param> ...\r\n");
+}
+
+
+void testList()
+{
+  reset();
+  std::string all = run("list");
+  CHECK(all.find("reverb.roomsize = 0.500   (0.00 to 1.00)\r\n") == 0);
+  CHECK(all.find("input.level = 5   (0.00 to 15.00)\r\n") != std::string::npos);
+
+  CHECK(run("list delay") ==
+        "delay.time[0] = 0.000   (0.00 to 1000.00)\r\n"
+        "delay.time[1] = 0.000   (0.00 to 1000.00)\r\n");
+  CHECK(run("list nothing") == "");
+}
+
+
+void testOtherLines()
+{
+  bool handled;
+
+  CHECK(run("store 2", &handled) == "" && handled);
+  CHECK(run("recall 7", &handled) == "error: no preset 7\r\n" && handled);
+
+  // single letter commands are left for doSerialCommands
+  run("pm", &handled);
+  CHECK(!handled);
+  run("store", &handled);
+  CHECK(!handled);
+  run("   ", &handled);
+  CHECK(!handled);
+}
+
+
+
+int main()
+{
+  testSplit();
+  testSet();
+  testSetErrors();
+  testTooMany();
+  testGet();
+  testList();
+  testOtherLines();
+
+  printf("console_test: %s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,371 @@
+/******************************************************
+   graph_run.cpp - runs a WAV thru a simulation of the
+   GEP's audio graph on a PC, for A/B against a reamp of
+   the same track thru the real thing (tools/reamp.py)
+
+     make -C tests graph_run
+     tests/graph_run di.wav sim.wav shaper.enabled=1 mix=0.7
+
+   Settings use the same names as the serial console
+   (console.h), plus mix for the mix pot, 0 = all dry to
+   1 = all wet. Anything not given is the default from
+   config.h, with every effect off.
+
+   Only the nodes that are in this repo are simulated:
+
+     in -> gate1 -> comp1 --------------> mixer4 dry -> peq1 -> out
+                          \-> shape1 -> mixer8_1 wet -/
+
+   The Teensy audio library isn't in the tree, so reverb,
+   chorus, flanger, delay, tremolo, the wah filter & the
+   SGTL-5000 aren't run. The mixers are plain gains added
+   & saturated. Their effects have to be left off on the
+   GEP for the two to match.
+
+   Reads 16 bit wavs at any rate, but the nodes are set
+   up for 44.1 kHz. The left channel is used, the output
+   is mono.
+
+ ******************************************************/
+
+#include "AudioStream.h"
+#include "../software/effect_noise_gate.h"
+#include "../software/effect_compressor.h"
+#include "../software/shapeCurves.h"
+#include "../software/effect_waveshaper_lut.h"
+#include "../software/filter_parametric_eq.h"
+
+#include <vector>
+
+
+#define NUM_PEQ_BANDS  8
+
+
+// the settings, defaults from config.h
+struct Settings
+{
+  float gateEnabled = 0;
+  float gateThreshold = -60;
+  float gateHysteresis = 6.0;
+  float gateHold = 50;
+  float gateRelease = 100;
+
+  float compEnabled = 0;
+  float compThreshold = -20;
+  float compRatio = 4.0;
+  float compKnee = 6.0;
+  float compAttack = 5.0;
+  float compRelease = 200;
+  float compGain = 1;
+  float compLookahead = 0;
+
+  float shapeEnabled = 0;
+  float shapeCurve = 0;
+  float shapeDrive = 4.0;
+  float shapeVolume = 0.5;
+
+  float eqEnabled = 0;
+  float peqFreq[NUM_PEQ_BANDS] = {80, 160, 320, 640, 1250, 2500, 5000, 10000};
+  float peqGain[NUM_PEQ_BANDS] = {0};
+  float peqQ[NUM_PEQ_BANDS] = {0.707, 1, 1, 1, 1, 1, 1, 0.707};
+
+  float mix = 0;
+} cfg;
+
+
+struct Setting
+{
+  const char *name;
+  float *value;
+};
+
+const Setting settings[] =
+{
+  {"gate.enabled",    &cfg.gateEnabled},
+  {"gate.threshold",  &cfg.gateThreshold},
+  {"gate.hysteresis", &cfg.gateHysteresis},
+  {"gate.hold",       &cfg.gateHold},
+  {"gate.release",    &cfg.gateRelease},
+  {"comp.enabled",    &cfg.compEnabled},
+  {"comp.threshold",  &cfg.compThreshold},
+  {"comp.ratio",      &cfg.compRatio},
+  {"comp.knee",       &cfg.compKnee},
+  {"comp.attack",     &cfg.compAttack},
+  {"comp.release",    &cfg.compRelease},
+  {"comp.gain",       &cfg.compGain},
+  {"comp.lookahead",  &cfg.compLookahead},
+  {"shaper.enabled",  &cfg.shapeEnabled},
+  {"shaper.curve",    &cfg.shapeCurve},
+  {"shaper.drive",    &cfg.shapeDrive},
+  {"shaper.volume",   &cfg.shapeVolume},
+  {"eq.enabled",      &cfg.eqEnabled},
+  {"mix",             &cfg.mix}
+};
+
+#define NUM_SETTINGS (sizeof(settings) / sizeof(settings[0]))
+
+
+AudioEffectNoiseGate     gate1;
+AudioEffectCompressor    comp1;
+AudioEffectWaveshapeLUT  shape1;
+AudioFilterParametricEQ  peq1;
+
+
+
+// name=value, the eq bands as eq.freq[n] etc.
+bool setSetting(const char *arg)
+{
+  char name[32];
+  const char *eq = strchr(arg, '=');
+  if (!eq || eq - arg >= (int)sizeof(name))
+    return false;
+
+  memcpy(name, arg, eq - arg);
+  name[eq - arg] = 0;
+
+  char *end;
+  float value = strtof(eq + 1, &end);
+  if (end == eq + 1 || *end)
+    return false;
+
+  for (uint8_t i = 0; i < NUM_SETTINGS; i++)
+  {
+    if (strcmp(name, settings[i].name) == 0)
+    {
+      *settings[i].value = value;
+      return true;
+    }
+  }
+
+  unsigned band;
+  char field[8];
+  if (sscanf(name, "eq.%7[a-z][%u]", field, &band) == 2 && band < NUM_PEQ_BANDS)
+  {
+    if (strcmp(field, "freq") == 0)
+      cfg.peqFreq[band] = value;
+    else if (strcmp(field, "gain") == 0)
+      cfg.peqGain[band] = value;
+    else if (strcmp(field, "q") == 0)
+      cfg.peqQ[band] = value;
+    else
+      return false;
+    return true;
+  }
+  return false;
+}
+
+
+// same as each effect's update() & enable() on the GEP
+void applySettings()
+{
+  gate1.threshold(cfg.gateThreshold, cfg.gateHysteresis);
+  gate1.hold(cfg.gateHold);
+  gate1.release(cfg.gateRelease);
+  gate1.setBypass(!cfg.gateEnabled);
+
+  comp1.threshold(cfg.compThreshold);
+  comp1.ratio(cfg.compRatio);
+  comp1.knee(cfg.compKnee);
+  comp1.attack(cfg.compAttack);
+  comp1.release(cfg.compRelease);
+  comp1.makeupGain(cfg.compGain * 6.0);
+  comp1.lookahead(cfg.compLookahead);
+  comp1.setBypass(!cfg.compEnabled);
+
+  uint8_t curve = constrain((int)cfg.shapeCurve, 0, NUM_SHAPE_CURVES - 1);
+  shape1.drive(cfg.shapeDrive);
+  shape1.shape(cfg.shapeEnabled ? shapeCurves[curve] : NULL);
+
+  // first & last bands are shelves, as in EQ.h
+  for (uint8_t i = 0; i < NUM_PEQ_BANDS; i++)
+  {
+    uint8_t type = i == 0 ? PEQ_LOW_SHELF : (i == NUM_PEQ_BANDS - 1 ? PEQ_HIGH_SHELF : PEQ_PEAK);
+    peq1.setBand(i, type, cfg.peqFreq[i], constrain(cfg.peqGain[i], -PEQ_MAX_GAIN, PEQ_MAX_GAIN),
+                 constrain(cfg.peqQ[i], 0.3, 10.0));
+  }
+  peq1.setBypass(!cfg.eqEnabled);
+
+  cfg.mix = constrain(cfg.mix, 0, 1.0);
+}
+
+
+
+// one node's update, NULL in or out is no block
+audio_block_t *runNode(AudioStream &node, audio_block_t *in)
+{
+  hostInput = in;
+  hostOutput = NULL;
+  node.update();
+  return hostOutput;
+}
+
+
+// one block thru the graph. The compressor's lookahead holds
+// on to a block, so the input blocks are taken in turn from
+// a few, & the shaper works on a copy
+void runGraph(const int16_t *in, int16_t *out)
+{
+  static audio_block_t blocks[4];
+  static uint8_t next = 0;
+  audio_block_t shaped;
+
+  audio_block_t *block = &blocks[next];
+  next = (next + 1) % 4;
+  memcpy(block->data, in, sizeof(block->data));
+
+  audio_block_t *dry = runNode(comp1, runNode(gate1, block));
+
+  audio_block_t *wet = NULL;
+  if (dry && cfg.shapeEnabled)
+  {
+    shaped = *dry;
+    wet = runNode(shape1, &shaped);
+  }
+
+  // mixer4, dry & the effects mixer's only input
+  audio_block_t mixed;
+  float dryGain = 1.0 - cfg.mix;
+  float wetGain = cfg.mix * cfg.shapeVolume;
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+  {
+    float s = 0;
+    if (dry)
+      s += dry->data[i] * dryGain;
+    if (wet)
+      s += wet->data[i] * wetGain;
+    mixed.data[i] = saturate16(lroundf(s));
+  }
+
+  audio_block_t *result = runNode(peq1, &mixed);
+  memcpy(out, result->data, sizeof(result->data));
+}
+
+
+
+// the parts of a wav file that matter here
+struct Wav
+{
+  uint32_t rate;
+  uint16_t channels;
+  std::vector<int16_t> left;
+};
+
+
+bool readWav(const char *path, Wav &wav)
+{
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+
+  char id[4];
+  uint32_t size;
+  bool gotFormat = false;
+  bool ok = false;
+
+  if (fread(id, 1, 4, f) != 4 || memcmp(id, "RIFF", 4) || fread(&size, 4, 1, f) != 1 ||
+      fread(id, 1, 4, f) != 4 || memcmp(id, "WAVE", 4))
+  {
+    fclose(f);
+    return false;
+  }
+
+  while (fread(id, 1, 4, f) == 4 && fread(&size, 4, 1, f) == 1)
+  {
+    if (memcmp(id, "fmt ", 4) == 0)
+    {
+      uint8_t fmt[16];
+      if (size < 16 || fread(fmt, 1, 16, f) != 16)
+        break;
+      uint16_t format = fmt[0] | fmt[1] << 8;
+      wav.channels = fmt[2] | fmt[3] << 8;
+      wav.rate = fmt[4] | fmt[5] << 8 | fmt[6] << 16 | (uint32_t)fmt[7] << 24;
+      uint16_t bits = fmt[14] | fmt[15] << 8;
+      if (format != 1 || bits != 16 || wav.channels == 0)
+        break;
+      gotFormat = true;
+      fseek(f, size - 16 + (size & 1), SEEK_CUR);
+    }
+    else if (memcmp(id, "data", 4) == 0 && gotFormat)
+    {
+      std::vector<int16_t> frames(size / 2);
+      size_t n = fread(frames.data(), 2, frames.size(), f);
+      for (size_t i = 0; i + wav.channels <= n; i += wav.channels)
+        wav.left.push_back(frames[i]);
+      ok = true;
+      break;
+    }
+    else
+      fseek(f, size + (size & 1), SEEK_CUR);
+  }
+  fclose(f);
+  return ok;
+}
+
+
+bool writeWav(const char *path, uint32_t rate, const std::vector<int16_t> &data)
+{
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+
+  uint32_t bytes = data.size() * 2;
+  uint32_t riff = 36 + bytes;
+  uint32_t fmtSize = 16;
+  uint16_t format = 1, channels = 1, align = 2, bits = 16;
+  uint32_t byteRate = rate * 2;
+
+  fwrite("RIFF", 1, 4, f);  fwrite(&riff, 4, 1, f);  fwrite("WAVE", 1, 4, f);
+  fwrite("fmt ", 1, 4, f);  fwrite(&fmtSize, 4, 1, f);
+  fwrite(&format, 2, 1, f); fwrite(&channels, 2, 1, f);
+  fwrite(&rate, 4, 1, f);   fwrite(&byteRate, 4, 1, f);
+  fwrite(&align, 2, 1, f);  fwrite(&bits, 2, 1, f);
+  fwrite("data", 1, 4, f);  fwrite(&bytes, 4, 1, f);
+  bool ok = fwrite(data.data(), 2, data.size(), f) == data.size();
+  return fclose(f) == 0 && ok;
+}
+
+
+
+int main(int argc, char **argv)
+{
+  if (argc < 3)
+  {
+    printf("usage: graph_run in.wav out.wav [name=value ...]\n");
+    return 2;
+  }
+
+  for (int i = 3; i < argc; i++)
+  {
+    if (!setSetting(argv[i]))
+    {
+      printf("error: unknown setting %s\n", argv[i]);
+      return 2;
+    }
+  }
+  applySettings();
+
+  Wav wav;
+  if (!readWav(argv[1], wav))
+  {
+    printf("error: %s isn't a 16 bit wav\n", argv[1]);
+    return 1;
+  }
+  if (wav.rate != 44100)
+    printf("warning: %u Hz, the nodes are set up for 44.1 kHz\n", wav.rate);
+
+  // whole blocks, the last one padded with silence
+  size_t length = wav.left.size();
+  std::vector<int16_t> out((length + AUDIO_BLOCK_SAMPLES - 1) / AUDIO_BLOCK_SAMPLES * AUDIO_BLOCK_SAMPLES);
+  wav.left.resize(out.size(), 0);
+
+  for (size_t i = 0; i < out.size(); i += AUDIO_BLOCK_SAMPLES)
+    runGraph(&wav.left[i], &out[i]);
+
+  out.resize(length);
+  if (!writeWav(argv[2], wav.rate, out))
+  {
+    printf("error: can't write %s\n", argv[2]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,321 @@
+/******************************************************
+   looper_test.cpp - the looper node (effect_looper.h)
+   with the SRAM in a RAM array, built & run on a PC
+
+     make -C tests test
+
+   The input is a ramp that doesn't repeat within a loop,
+   so every sample played back can be checked against the
+   one that was recorded at that point of the loop.
+
+ ******************************************************/
+
+#define USE_LOOPER
+#define LOOPER_SRAM_STUB
+
+#include "AudioStream.h"
+#include "../software/effect_looper.h"
+
+
+// the whole chip, the delay's part too
+int16_t sram[SRAM_SAMPLES];
+
+// reads & writes outside the looper's part
+uint32_t outside = 0;
+
+#define DELAY_FILL  0x5A5A
+
+
+void AudioEffectLooper :: sramRead(uint32_t sample, int16_t *data, uint16_t n)
+{
+  if (sample < memBegin || sample + n > memBegin + memSamples)
+  {
+    outside++;
+    return;
+  }
+  memcpy(data, &sram[sample], n * sizeof(int16_t));
+}
+
+
+void AudioEffectLooper :: sramWrite(uint32_t sample, const int16_t *data, uint16_t n)
+{
+  if (sample < memBegin || sample + n > memBegin + memSamples)
+  {
+    outside++;
+    return;
+  }
+  memcpy(&sram[sample], data, n * sizeof(int16_t));
+}
+
+
+
+int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+
+// samples since the start
+long sampleClock = 0;
+
+// what the loop should hold, & a copy from before an overdub
+int16_t model[SRAM_SAMPLES];
+int16_t saved[SRAM_SAMPLES];
+
+
+int16_t ramp(long n)
+{
+  return (n * 7) % 20000 - 10000;
+}
+
+
+// one update with the ramp as the input, or a constant.
+// Returns what was sent, NULL if nothing
+audio_block_t *runBlock(AudioEffectLooper &looper, bool useRamp = true, int16_t value = 0)
+{
+  audio_block_t in;
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+    in.data[i] = useRamp ? ramp(sampleClock + i) : value;
+
+  hostInput = &in;
+  hostOutput = NULL;
+  looper.update();
+  sampleClock += AUDIO_BLOCK_SAMPLES;
+  return hostOutput;
+}
+
+
+// records the ramp from an empty looper for blocks, or until
+// the memory is full, then plays the first block
+void recordLoop(AudioEffectLooper &looper, uint16_t blocks)
+{
+  looper.command(LOOP_CMD_CLEAR);
+  looper.command(LOOP_CMD_RECORD);
+
+  long start = sampleClock;
+  for (uint16_t b = 0; b < blocks; b++)
+  {
+    runBlock(looper);
+    if (looper.state() != LOOP_RECORDING)
+      break;
+  }
+  if (looper.state() == LOOP_RECORDING)
+    looper.command(LOOP_CMD_PLAY);
+  runBlock(looper, false);
+
+  for (uint32_t i = 0; i < looper.length(); i++)
+    model[i] = ramp(start + i);
+}
+
+
+// plays blocks with silence in, counts the samples that
+// aren't what the loop should hold
+uint32_t playErrors(AudioEffectLooper &looper, uint16_t blocks)
+{
+  uint32_t errors = 0;
+
+  for (uint16_t b = 0; b < blocks; b++)
+  {
+    uint32_t len = looper.length();
+    uint32_t pos = looper.position();
+
+    audio_block_t *out = runBlock(looper, false);
+    if (!out)
+    {
+      errors += AUDIO_BLOCK_SAMPLES;
+      continue;
+    }
+
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+    {
+      if (out->data[i] != model[(pos + i) % len])
+        errors++;
+    }
+  }
+  return errors;
+}
+
+
+// overdubs a constant for blocks, then stops the overdub
+void overdub(AudioEffectLooper &looper, int16_t value, uint16_t blocks)
+{
+  uint32_t len = looper.length();
+  memcpy(saved, model, len * sizeof(int16_t));
+
+  looper.command(LOOP_CMD_RECORD);
+  for (uint16_t b = 0; b < blocks; b++)
+  {
+    uint32_t pos = looper.position();
+    runBlock(looper, false, value);
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+      model[(pos + i) % len] = saturate16(model[(pos + i) % len] + value);
+  }
+
+  looper.command(LOOP_CMD_RECORD);
+  runBlock(looper, false);
+}
+
+
+// undo swaps the loop with the copy from before the overdub
+void undo(AudioEffectLooper &looper)
+{
+  for (uint32_t i = 0; i < looper.length(); i++)
+  {
+    int16_t t = model[i];
+    model[i] = saved[i];
+    saved[i] = t;
+  }
+  looper.command(LOOP_CMD_UNDO);
+}
+
+
+
+// a loop of whole blocks, then one that stops when the
+// memory is full, which isn't
+void testLoopLength(AudioEffectLooper &looper)
+{
+  recordLoop(looper, 10);
+  CHECK(looper.state() == LOOP_PLAYING);
+  CHECK(looper.length() == 10 * AUDIO_BLOCK_SAMPLES);
+  CHECK(playErrors(looper, 25) == 0);
+
+  recordLoop(looper, 1000);
+  CHECK(looper.length() == SRAM_LOOPER_SAMPLES);
+  CHECK(looper.length() % AUDIO_BLOCK_SAMPLES != 0);
+
+  // three passes, each wrap is in the middle of a block
+  uint16_t blocks = 3 * SRAM_LOOPER_SAMPLES / AUDIO_BLOCK_SAMPLES;
+  CHECK(playErrors(looper, blocks) == 0);
+  CHECK(looper.position() % AUDIO_BLOCK_SAMPLES != 0);
+
+  // an overdub across the wrap, a loop this long has no undo
+  overdub(looper, 100, SRAM_LOOPER_SAMPLES / AUDIO_BLOCK_SAMPLES + 2);
+  CHECK(!looper.canUndo());
+  CHECK(playErrors(looper, blocks) == 0);
+}
+
+
+
+void testOverdubUndo(AudioEffectLooper &looper)
+{
+  // one pass, so the undo copy is complete
+  recordLoop(looper, 10);
+  overdub(looper, 100, 10);
+  CHECK(looper.state() == LOOP_PLAYING);
+  CHECK(looper.canUndo());
+  CHECK(playErrors(looper, 15) == 0);
+
+  undo(looper);
+  CHECK(playErrors(looper, 15) == 0);
+
+  // redo
+  undo(looper);
+  CHECK(playErrors(looper, 15) == 0);
+
+  // an overdub longer than a pass still undoes to before it
+  recordLoop(looper, 10);
+  overdub(looper, 100, 25);
+  CHECK(playErrors(looper, 10) == 0);
+  undo(looper);
+  CHECK(playErrors(looper, 10) == 0);
+
+  // undo before a pass is copied happens when it is, the
+  // overdub stops straight away
+  recordLoop(looper, 10);
+  memcpy(saved, model, looper.length() * sizeof(int16_t));
+  looper.command(LOOP_CMD_RECORD);
+  for (uint8_t b = 0; b < 3; b++)
+    runBlock(looper, false, 100);
+  looper.command(LOOP_CMD_UNDO);
+  runBlock(looper, false);
+  CHECK(looper.state() == LOOP_PLAYING);
+  CHECK(looper.canUndo());
+
+  for (uint8_t b = 0; b < 10; b++)
+    runBlock(looper, false);
+  memcpy(model, saved, looper.length() * sizeof(int16_t));
+  CHECK(playErrors(looper, 15) == 0);
+}
+
+
+
+// both copies have to fit in the memory
+void testUndoLimit()
+{
+  const uint32_t half = 10 * AUDIO_BLOCK_SAMPLES;
+  AudioEffectLooper looper(SRAM_LOOPER_BEGIN, 2 * half);
+
+  recordLoop(looper, 10);
+  overdub(looper, 100, 10);
+  CHECK(looper.canUndo());
+
+  // one block over half
+  recordLoop(looper, 11);
+  CHECK(looper.length() > half);
+  overdub(looper, 100, 11);
+  CHECK(!looper.canUndo());
+
+  // does nothing
+  looper.command(LOOP_CMD_UNDO);
+  CHECK(playErrors(looper, 15) == 0);
+}
+
+
+
+// two commands before a block are both applied
+void testQueue(AudioEffectLooper &looper)
+{
+  recordLoop(looper, 10);
+  for (uint8_t b = 0; b < 4; b++)
+    runBlock(looper, false);
+
+  // stop then play, restarts the loop
+  looper.command(LOOP_CMD_PLAY);
+  looper.command(LOOP_CMD_PLAY);
+  CHECK(runBlock(looper, false) != NULL);
+  CHECK(looper.state() == LOOP_PLAYING);
+  CHECK(looper.position() == AUDIO_BLOCK_SAMPLES);
+
+  // overdub on & straight off, nothing recorded
+  looper.command(LOOP_CMD_RECORD);
+  looper.command(LOOP_CMD_RECORD);
+  runBlock(looper, false, 100);
+  CHECK(looper.state() == LOOP_PLAYING);
+  CHECK(playErrors(looper, 15) == 0);
+
+  // more than the queue holds, the extra ones are dropped,
+  // an odd number are left
+  for (uint8_t i = 0; i < LOOP_QUEUE_SIZE + 2; i++)
+    looper.command(LOOP_CMD_PLAY);
+  runBlock(looper, false);
+  CHECK(looper.state() == LOOP_STOPPED);
+}
+
+
+
+int main()
+{
+  for (uint32_t i = 0; i < SRAM_SAMPLES; i++)
+    sram[i] = DELAY_FILL;
+
+  AudioEffectLooper looper(SRAM_LOOPER_BEGIN, SRAM_LOOPER_SAMPLES);
+
+  // nothing is sent until there's a loop
+  CHECK(runBlock(looper) == NULL);
+  CHECK(looper.state() == LOOP_EMPTY);
+
+  testLoopLength(looper);
+  testOverdubUndo(looper);
+  testUndoLimit();
+  testQueue(looper);
+
+  // the delay's part of the chip is never touched
+  uint32_t changed = 0;
+  for (uint32_t i = 0; i < SRAM_LOOPER_BEGIN; i++)
+    changed += sram[i] != (int16_t)DELAY_FILL;
+  CHECK(changed == 0);
+  CHECK(outside == 0);
+
+  printf("looper_test: %s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
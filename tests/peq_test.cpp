@@ -0,0 +1,321 @@
+/******************************************************
+   peq_test.cpp - the software parametric EQ node
+   (filter_parametric_eq.h) with a reference q31 cascade
+   in place of CMSIS (stubs/arm_math.h), built & run on
+   a PC
+
+     make -C tests test
+
+   Sines are run thru the node and the gain measured at
+   each band's frequency, against the cookbook response
+   worked out here in double precision. Then a boost too
+   big for the old fixed headroom, which used to wrap
+   around, and the cost per stage per block.
+
+ ******************************************************/
+
+#include <chrono>
+
+#include "AudioStream.h"
+#include "../software/filter_parametric_eq.h"
+
+
+
+int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+
+struct Band
+{
+  uint8_t type;
+  double freq;
+  double gaindB;
+  double q;
+};
+
+// blocks run before measuring, & measured
+#define SETTLE_BLOCKS   400
+#define MEASURE_BLOCKS  200
+
+// blocks timed for each number of stages
+#define BENCH_BLOCKS    100000
+
+
+
+// cookbook |H| at f, in double precision
+double bandGain(const Band &b, double f)
+{
+  double A = pow(10.0, b.gaindB / 40.0);
+  double w0 = 2.0 * M_PI * b.freq / AUDIO_SAMPLE_RATE_EXACT;
+  double cw = cos(w0), alpha = sin(w0) / (2.0 * b.q);
+  double beta = 2.0 * sqrt(A) * alpha;
+  double n[3], d[3];
+
+  if (b.type == PEQ_LOW_SHELF)
+  {
+    n[0] = A * ((A + 1) - (A - 1) * cw + beta);
+    n[1] = 2 * A * ((A - 1) - (A + 1) * cw);
+    n[2] = A * ((A + 1) - (A - 1) * cw - beta);
+    d[0] = (A + 1) + (A - 1) * cw + beta;
+    d[1] = -2 * ((A - 1) + (A + 1) * cw);
+    d[2] = (A + 1) + (A - 1) * cw - beta;
+  }
+  else if (b.type == PEQ_HIGH_SHELF)
+  {
+    n[0] = A * ((A + 1) + (A - 1) * cw + beta);
+    n[1] = -2 * A * ((A - 1) + (A + 1) * cw);
+    n[2] = A * ((A + 1) + (A - 1) * cw - beta);
+    d[0] = (A + 1) - (A - 1) * cw + beta;
+    d[1] = 2 * ((A - 1) - (A + 1) * cw);
+    d[2] = (A + 1) - (A - 1) * cw - beta;
+  }
+  else
+  {
+    n[0] = 1 + alpha * A;  n[1] = -2 * cw;  n[2] = 1 - alpha * A;
+    d[0] = 1 + alpha / A;  d[1] = -2 * cw;  d[2] = 1 - alpha / A;
+  }
+
+  double w = 2.0 * M_PI * f / AUDIO_SAMPLE_RATE_EXACT;
+  double nr = n[0] + n[1] * cos(w) + n[2] * cos(2 * w);
+  double ni = -n[1] * sin(w) - n[2] * sin(2 * w);
+  double dr = d[0] + d[1] * cos(w) + d[2] * cos(2 * w);
+  double di = -d[1] * sin(w) - d[2] * sin(2 * w);
+  return sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+
+double expectedGaindB(const Band *bands, uint8_t n, double f)
+{
+  double g = 1.0;
+  for (uint8_t i = 0; i < n; i++)
+    g *= bandGain(bands[i], f);
+  return 20.0 * log10(g);
+}
+
+
+void setBands(AudioFilterParametricEQ &peq, const Band *bands, uint8_t n)
+{
+  for (uint8_t i = 0; i < PEQ_MAX_STAGES; i++)
+  {
+    if (i < n)
+      peq.setBand(i, bands[i].type, bands[i].freq, bands[i].gaindB, bands[i].q);
+    else
+      peq.setBand(i, PEQ_PEAK, 1000, 0, 1);
+  }
+  peq.setBypass(false);
+}
+
+
+
+// the sine's phase, carried across blocks
+double phase = 0;
+
+// one block of a sine thru the node, the output's in the
+// block. Returns the sign changes in it
+uint16_t runSine(AudioFilterParametricEQ &peq, audio_block_t &block, double f, double amplitude)
+{
+  static int16_t last = 0;
+  uint16_t crossings = 0;
+
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+  {
+    block.data[i] = (int16_t)lround(amplitude * sin(phase));
+    phase += 2.0 * M_PI * f / AUDIO_SAMPLE_RATE_EXACT;
+  }
+  phase = fmod(phase, 2.0 * M_PI);
+
+  hostInput = &block;
+  peq.update();
+
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+  {
+    crossings += (block.data[i] < 0) != (last < 0);
+    last = block.data[i];
+  }
+  return crossings;
+}
+
+
+// gain of the node at f, in dB
+double measureGaindB(AudioFilterParametricEQ &peq, double f, double amplitude)
+{
+  audio_block_t block;
+  double sum = 0;
+
+  for (uint16_t b = 0; b < SETTLE_BLOCKS; b++)
+    runSine(peq, block, f, amplitude);
+
+  for (uint16_t b = 0; b < MEASURE_BLOCKS; b++)
+  {
+    runSine(peq, block, f, amplitude);
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+      sum += (double)block.data[i] * block.data[i];
+  }
+
+  double rms = sqrt(sum / (MEASURE_BLOCKS * AUDIO_BLOCK_SAMPLES));
+  return 20.0 * log10(rms / (amplitude / sqrt(2.0)));
+}
+
+
+// each band's frequency, measured against the cookbook
+void checkResponse(const char *name, const Band *bands, uint8_t n, double amplitude)
+{
+  AudioFilterParametricEQ peq;
+  setBands(peq, bands, n);
+
+  double worst = 0;
+  for (uint8_t i = 0; i < n; i++)
+  {
+    double got = measureGaindB(peq, bands[i].freq, amplitude);
+    double want = expectedGaindB(bands, n, bands[i].freq);
+    worst = max(worst, fabs(got - want));
+  }
+  printf("  %s: %u stages, %u bits headroom, worst %.3f dB\n", name, peq.stagesInUse(), peq.headroomBits(), worst);
+  CHECK(worst < 0.1);
+}
+
+
+
+// 8 bands, the way EQ.h sets them up
+void testBands()
+{
+  const Band boost[8] =
+  {
+    {PEQ_LOW_SHELF,  100,   6,  0.7},
+    {PEQ_PEAK,       200,  -9,  1.0},
+    {PEQ_PEAK,       400,   9,  2.0},
+    {PEQ_PEAK,       800,  -12, 4.0},
+    {PEQ_PEAK,       1600,  12, 1.0},
+    {PEQ_PEAK,       3200,  -6, 0.5},
+    {PEQ_PEAK,       6400,  3,  8.0},
+    {PEQ_HIGH_SHELF, 12000, -9, 0.7}
+  };
+  checkResponse("mixed bands", boost, 8, 4000);
+
+  // one band at a time
+  for (uint8_t i = 1; i < 7; i++)
+  {
+    Band one = {PEQ_PEAK, boost[i].freq, 12, 2.0};
+    AudioFilterParametricEQ peq;
+    setBands(peq, &one, 1);
+    CHECK(fabs(measureGaindB(peq, one.freq, 4000) - 12.0) < 0.1);
+  }
+}
+
+
+
+// boosts past the old fixed 18 dB of headroom
+void testHeadroom()
+{
+  AudioFilterParametricEQ peq;
+  Band stacked[8];
+  for (uint8_t i = 0; i < 8; i++)
+    stacked[i] = {PEQ_PEAK, 1000, 12, 1.0};
+
+  // 48 dB, a small input still comes out right
+  checkResponse("4 x 12 dB", stacked, 4, 100);
+  setBands(peq, stacked, 4);
+  CHECK(peq.headroomBits() == 9);
+
+  // narrow peaks between the grid points are still seen
+  Band narrow[2] = {{PEQ_PEAK, 1234, 12, 10}, {PEQ_PEAK, 1234, 12, 10}};
+  checkResponse("2 x 12 dB, Q 10", narrow, 2, 1000);
+  setBands(peq, narrow, 2);
+  CHECK(peq.headroomBits() == 5);
+
+  // 96 dB, clips instead of wrapping around, so the output
+  // crosses zero twice a cycle like the input
+  setBands(peq, stacked, 8);
+  CHECK(peq.headroomBits() == 17);
+
+  audio_block_t block;
+  for (uint16_t b = 0; b < SETTLE_BLOCKS; b++)
+    runSine(peq, block, 1000, 1000);
+
+  uint32_t crossings = 0;
+  int16_t peak = 0;
+  for (uint16_t b = 0; b < MEASURE_BLOCKS; b++)
+  {
+    crossings += runSine(peq, block, 1000, 1000);
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+      peak = max(peak, block.data[i]);
+  }
+  double cycles = 1000.0 * MEASURE_BLOCKS * AUDIO_BLOCK_SAMPLES / AUDIO_SAMPLE_RATE_EXACT;
+  printf("  8 x 12 dB: %u crossings for %.0f cycles\n", crossings, cycles);
+  CHECK(fabs(crossings - 2 * cycles) <= 2);
+  CHECK(peak == 32767);
+
+  // back down, the state is rescaled so it carries on
+  setBands(peq, stacked, 1);
+  CHECK(peq.headroomBits() == PEQ_HEADROOM_BITS);
+  CHECK(fabs(measureGaindB(peq, 1000, 4000) - 12.0) < 0.1);
+}
+
+
+
+// nothing done with no bands or bypassed
+void testPassThru()
+{
+  AudioFilterParametricEQ peq;
+  Band one = {PEQ_PEAK, 1000, 6, 1.0};
+  audio_block_t block;
+
+  setBands(peq, &one, 0);
+  CHECK(peq.stagesInUse() == 0);
+  CHECK(fabs(measureGaindB(peq, 1000, 4000)) < 0.01);
+
+  setBands(peq, &one, 1);
+  peq.setBypass(true);
+  runSine(peq, block, 1000, 4000);
+  CHECK(block.data[10] == (int16_t)lround(4000 * sin(phase - (AUDIO_BLOCK_SAMPLES - 10) * 2.0 * M_PI * 1000 / AUDIO_SAMPLE_RATE_EXACT)));
+}
+
+
+
+// host time per stage per block. Only a sanity check
+// against real time, the Teensy figures come from the 'b'
+// serial command (benchmark.h)
+void benchmark()
+{
+  AudioFilterParametricEQ peq;
+  Band bands[8];
+  audio_block_t block;
+
+  for (uint8_t stages = 1; stages <= PEQ_MAX_STAGES; stages++)
+  {
+    for (uint8_t i = 0; i < stages; i++)
+      bands[i] = {PEQ_PEAK, 100.0 * (i + 1), 6, 1.0};
+    setBands(peq, bands, stages);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < BENCH_BLOCKS; n++)
+    {
+      for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+        block.data[i] = (int16_t)(i * 512 - 32768 + n);
+      hostInput = &block;
+      peq.update();
+    }
+    std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+
+    double perBlock = secs.count() / BENCH_BLOCKS;
+    double blockTime = AUDIO_BLOCK_SAMPLES / AUDIO_SAMPLE_RATE_EXACT;
+    printf("  %u stages: %.0f ns/block, %.0f ns/stage/block, %.0fx real time\n",
+           stages, perBlock * 1e9, perBlock * 1e9 / stages, blockTime / perBlock);
+    CHECK(perBlock < blockTime);
+  }
+}
+
+
+
+int main()
+{
+  testBands();
+  testHeadroom();
+  testPassThru();
+  benchmark();
+
+  printf("peq_test: %s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
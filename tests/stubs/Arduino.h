@@ -0,0 +1,60 @@
+/******************************************************
+   Arduino.h - just enough of the Arduino core to build
+   the firmware headers on a PC for the host tests
+
+   Serial keeps what's printed in Serial.out.
+
+ ******************************************************/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define F(s)  (s)
+#define PI    3.1415926535897932384626433832795
+#define PROGMEM
+
+// one thread, nothing to stop
+static inline void __disable_irq() {}
+static inline void __enable_irq()  {}
+
+#define constrain(x, lo, hi)  ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+
+typedef bool boolean;
+
+
+class HostSerial {
+  public:
+    std::string out;
+
+    void print(const char *s)           { out += s; }
+    void print(char c)                  { out += c; }
+    void print(int v)                   { out += std::to_string(v); }
+    void print(unsigned int v)          { out += std::to_string(v); }
+    void print(long v)                  { out += std::to_string(v); }
+    void print(unsigned long v)         { out += std::to_string(v); }
+    void print(double v, int digits = 2)
+    {
+      char s[32];
+      snprintf(s, sizeof(s), "%.*f", digits, v);
+      out += s;
+    }
+
+    template <class T> void println(T v)  { print(v); out += "\r\n"; }
+    void println(double v, int digits)    { print(v, digits); out += "\r\n"; }
+    void println()                        { out += "\r\n"; }
+};
+
+HostSerial Serial;
+
+#endif
@@ -0,0 +1,43 @@
+/******************************************************
+   AudioStream.h - the parts of the audio library's node
+   base class used by the effect nodes, for the host tests
+
+   The test puts the input block in hostInput (NULL for
+   none) and finds what was sent in hostOutput after
+   update().
+
+ ******************************************************/
+
+#ifndef HOST_AUDIO_STREAM_H
+#define HOST_AUDIO_STREAM_H
+
+#include "Arduino.h"
+
+
+#define AUDIO_BLOCK_SAMPLES      128
+#define AUDIO_SAMPLE_RATE_EXACT  44117.64706f
+
+struct audio_block_t
+{
+  int16_t data[AUDIO_BLOCK_SAMPLES];
+};
+
+audio_block_t *hostInput;
+audio_block_t *hostOutput;
+audio_block_t hostBlock;
+
+
+class AudioStream {
+  public:
+    AudioStream(uint8_t numInputs, audio_block_t **queue) {}
+    virtual void update(void) = 0;
+
+  protected:
+    audio_block_t *receiveReadOnly()                { return hostInput; }
+    audio_block_t *receiveWritable()                { return hostInput; }
+    static audio_block_t *allocate()                { return &hostBlock; }
+    static void release(audio_block_t *block)       {}
+    void transmit(audio_block_t *block)             { hostOutput = block; }
+};
+
+#endif
@@ -0,0 +1,72 @@
+/******************************************************
+   arm_math.h - a reference direct form I q31 biquad
+   cascade in place of CMSIS, for the host tests
+
+   Same arithmetic as arm_biquad_cascade_df1_q31(): a 64
+   bit accumulator, shifted back to q31 by 31 - postShift
+   and cut to 32 bits, so it wraps around like the real one
+   instead of saturating.
+
+ ******************************************************/
+
+#ifndef HOST_ARM_MATH_H
+#define HOST_ARM_MATH_H
+
+#include <stdint.h>
+#include <string.h>
+
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+
+struct arm_biquad_casd_df1_inst_q31
+{
+  uint32_t numStages;
+  q31_t *pState;
+  const q31_t *pCoeffs;
+  uint8_t postShift;
+};
+
+
+static inline void arm_biquad_cascade_df1_init_q31(arm_biquad_casd_df1_inst_q31 *S, uint8_t numStages,
+    const q31_t *pCoeffs, q31_t *pState, int8_t postShift)
+{
+  S->numStages = numStages;
+  S->pCoeffs = pCoeffs;
+  S->postShift = postShift;
+  memset(pState, 0, numStages * 4 * sizeof(q31_t));
+  S->pState = pState;
+}
+
+
+static inline void arm_biquad_cascade_df1_q31(const arm_biquad_casd_df1_inst_q31 *S,
+    const q31_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+  const q31_t *in = pSrc;
+
+  for (uint32_t s = 0; s < S->numStages; s++)
+  {
+    const q31_t *c = &S->pCoeffs[s * 5];
+    q31_t *st = &S->pState[s * 4];
+    q31_t x1 = st[0], x2 = st[1], y1 = st[2], y2 = st[3];
+
+    for (uint32_t n = 0; n < blockSize; n++)
+    {
+      q31_t x0 = in[n];
+      q63_t acc = (q63_t)c[0] * x0 + (q63_t)c[1] * x1 + (q63_t)c[2] * x2
+                + (q63_t)c[3] * y1 + (q63_t)c[4] * y2;
+      q31_t y0 = (q31_t)(acc >> (31 - S->postShift));
+
+      x2 = x1;
+      x1 = x0;
+      y2 = y1;
+      y1 = y0;
+      pDst[n] = y0;
+    }
+    st[0] = x1; st[1] = x2; st[2] = y1; st[3] = y2;
+
+    // the next stage works on this one's output
+    in = pDst;
+  }
+}
+
+#endif
@@ -0,0 +1,26 @@
+/******************************************************
+   dspinst.h - C versions of the DSP instructions used by
+   the effect nodes, for the host tests
+
+ ******************************************************/
+
+#ifndef HOST_DSPINST_H
+#define HOST_DSPINST_H
+
+#include <stdint.h>
+
+
+static inline int32_t saturate16(int32_t val)
+{
+  return val > 32767 ? 32767 : (val < -32768 ? -32768 : val);
+}
+
+// ssat with an asr, val >> rshift clipped to bits signed
+static inline int32_t signed_saturate_rshift(int32_t val, int bits, int rshift)
+{
+  int32_t max = (1 << (bits - 1)) - 1;
+  val >>= rshift;
+  return val > max ? max : (val < -max - 1 ? -max - 1 : val);
+}
+
+#endif
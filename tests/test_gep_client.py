@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""
+test_gep_client.py - gep_client.py against the simulated device
+
+    python3 tests/test_gep_client.py
+"""
+
+import os
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "..", "tools"))
+
+from gep_client import (EEPROM_VERSION, GET, NAK, PING, GepClient,  # noqa: E402
+                        ProtocolError, SimDevice, frame)
+
+
+class GepClientTest(unittest.TestCase):
+
+    def setUp(self):
+        self.gep = GepClient("sim", timeout=0.5)
+
+    def test_ping(self):
+        self.assertEqual(self.gep.ping(), (EEPROM_VERSION, len(SimDevice.PARAMS)))
+
+    def test_list(self):
+        params = self.gep.list()
+        self.assertEqual(len(params), len(SimDevice.PARAMS))
+        for i, (name, ptype, lo, hi) in enumerate(SimDevice.PARAMS):
+            self.assertEqual(params[name], (i, ptype, lo, hi))
+
+    def test_get(self):
+        values = self.gep.get("reverb.roomsize", "delay.time[1]")
+        self.assertEqual(values, {"reverb.roomsize": 0.0, "delay.time[1]": 0.0})
+
+    def test_batched_set(self):
+        count = self.gep.set(**{"reverb.roomsize": 0.5, "delay.time[1]": 250, "input.level": 20})
+        self.assertEqual(count, 3)
+
+        # constrained & rounded like the device
+        values = self.gep.get("reverb.roomsize", "delay.time[1]", "input.level")
+        self.assertEqual(values, {"reverb.roomsize": 0.5, "delay.time[1]": 250.0, "input.level": 15.0})
+
+    def test_bad_id(self):
+        with self.assertRaisesRegex(ProtocolError, "bad param id"):
+            self.gep.request(GET, bytes([len(SimDevice.PARAMS)]))
+
+    def test_bad_crc(self):
+        data = bytearray(frame(PING))
+        data[-1] ^= 0xFF
+        self.gep.port.write(bytes(data))
+
+        naks = [d for c, d in self.gep.frames() if c == NAK]
+        self.assertEqual(naks, [bytes([PING, 1])])
+
+        # and it still answers
+        self.assertEqual(self.gep.ping()[0], EEPROM_VERSION)
+
+    def test_meters(self):
+        self.gep.stream(10)
+        meters = next(self.gep.meters())
+        self.gep.stream(0)
+        self.assertEqual(meters["cpu"], 12.5)
+        self.assertEqual(meters["out_lufs"], -18.0)
+
+    def test_save(self):
+        self.assertTrue(self.gep.save())
+
+
+if __name__ == "__main__":
+    unittest.main()
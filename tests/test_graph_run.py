@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+test_graph_run.py - graph_run.cpp, the offline graph simulation
+
+    make -C tests test
+"""
+
+import math
+import os
+import struct
+import subprocess
+import tempfile
+import unittest
+import wave
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+GRAPH_RUN = os.path.join(HERE, "graph_run")
+RATE = 44100
+
+
+def write_wav(path, samples, channels=1):
+    with wave.open(path, "wb") as w:
+        w.setnchannels(channels)
+        w.setsampwidth(2)
+        w.setframerate(RATE)
+        w.writeframes(struct.pack("<%dh" % len(samples), *samples))
+
+
+def read_wav(path):
+    with wave.open(path, "rb") as w:
+        data = w.readframes(w.getnframes())
+        return list(struct.unpack("<%dh" % (len(data) // 2), data))
+
+
+def sine(freq, amplitude, seconds):
+    return [round(amplitude * math.sin(2 * math.pi * freq * n / RATE)) for n in range(int(RATE * seconds))]
+
+
+def rms_db(samples):
+    return 10 * math.log10(sum(s * s for s in samples) / len(samples))
+
+
+class GraphRunTest(unittest.TestCase):
+
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.input = os.path.join(self.dir.name, "in.wav")
+        self.output = os.path.join(self.dir.name, "out.wav")
+
+    def tearDown(self):
+        self.dir.cleanup()
+
+    def run_graph(self, *settings):
+        return subprocess.run([GRAPH_RUN, self.input, self.output] + list(settings),
+                              capture_output=True, text=True)
+
+    def test_all_off_is_untouched(self):
+        # not a whole number of blocks
+        samples = sine(440, 8000, 0.5)[:-17]
+        write_wav(self.input, samples)
+        self.assertEqual(self.run_graph().returncode, 0)
+        self.assertEqual(read_wav(self.output), samples)
+
+    def test_stereo_uses_left(self):
+        left = sine(440, 8000, 0.1)
+        frames = [s for pair in zip(left, [0] * len(left)) for s in pair]
+        write_wav(self.input, frames, channels=2)
+        self.assertEqual(self.run_graph().returncode, 0)
+        self.assertEqual(read_wav(self.output), left)
+
+    def test_eq_band(self):
+        samples = sine(1250, 4000, 1.0)
+        write_wav(self.input, samples)
+        self.run_graph("eq.enabled=1", "eq.gain[4]=6")
+
+        # after the filter settles
+        out = read_wav(self.output)[RATE // 2:]
+        gain = rms_db(out) - rms_db(samples[RATE // 2:])
+        self.assertAlmostEqual(gain, 6.0, delta=0.1)
+
+    def test_shaper_mix(self):
+        samples = sine(220, 16000, 0.2)
+        write_wav(self.input, samples)
+
+        # all wet with the hard curve at full drive, a square wave
+        self.run_graph("shaper.enabled=1", "shaper.curve=1", "shaper.drive=16", "shaper.volume=1", "mix=1")
+        out = read_wav(self.output)
+        self.assertGreater(sum(abs(s) > 32000 for s in out), 0.9 * len(out))
+
+        # all wet with nothing on is silent, same as the GEP
+        self.run_graph("mix=1")
+        self.assertEqual(set(read_wav(self.output)), {0})
+
+    def test_gate_closes(self):
+        samples = sine(440, 8000, 0.2) + [3] * RATE
+        write_wav(self.input, samples)
+        self.run_graph("gate.enabled=1", "gate.threshold=-40", "gate.hold=0", "gate.release=10")
+        out = read_wav(self.output)
+        self.assertNotEqual(out[:1000], [0] * 1000)
+        self.assertEqual(out[-RATE // 2:], [0] * (RATE // 2))
+
+    def test_bad_setting(self):
+        write_wav(self.input, [0] * 128)
+        result = self.run_graph("reverb.volume=1")
+        self.assertEqual(result.returncode, 2)
+        self.assertIn("unknown setting reverb.volume", result.stdout)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,202 @@
+/******************************************************
+   waveshaper_test.cpp - the table lookup waveshaper
+   (effect_waveshaper_lut.h) against the curve functions
+   the tables were made from, & its throughput, built &
+   run on a PC
+
+     make -C tests test
+
+   The interpolated output is checked for every 16 bit
+   input. Between table points it can be off the curve by
+   the straight line error, which is largest where the
+   curve bends most, plus the rounding of the table.
+
+ ******************************************************/
+
+#include <chrono>
+
+#include "AudioStream.h"
+#include "../software/shapeCurves.h"
+#include "../software/effect_waveshaper_lut.h"
+
+
+
+int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+
+// the generator functions in shapeCurves.h, -1.0 to 1.0
+double curveSoft(double x)
+{
+  return tanh(2.5 * x) / tanh(2.5);
+}
+
+double curveHard(double x)
+{
+  return constrain(2.0 * x, -1.0, 1.0);
+}
+
+double curveTube(double x)
+{
+  if (x >= 0)
+    return (1.0 - exp(-3.0 * x)) / (1.0 - exp(-3.0));
+  return -0.7 * (1.0 - exp(1.5 * x)) / (1.0 - exp(-1.5));
+}
+
+double curveFold(double x)
+{
+  return sin(0.9 * M_PI * x);
+}
+
+struct Curve
+{
+  double (*f)(double);
+
+  // most the interpolation can be off, in lsbs. The straight
+  // line error, step^2 / 8 * the most f'' * 32767, plus 0.5
+  // for the table rounding & 1 for the >> 8 rounding down
+  double maxError;
+};
+
+// same order as shapeCurves[]
+const Curve curves[NUM_SHAPE_CURVES] =
+{
+  {curveSoft, 2.7},     // f'' up to 4.9
+  {curveHard, 1.5},     // straight lines
+  {curveTube, 3.9},     // f'' 9.5 at 0+
+  {curveFold, 3.5}      // f'' up to 8.0
+};
+
+// blocks timed for each curve
+#define BENCH_BLOCKS  200000
+
+
+
+// each table point is the function rounded
+void testTables()
+{
+  for (uint8_t c = 0; c < NUM_SHAPE_CURVES; c++)
+  {
+    double worst = 0;
+    for (uint16_t i = 0; i < SHAPE_TABLE_SIZE; i++)
+    {
+      double y = curves[c].f(-1.0 + 2.0 * i / 256) * 32767;
+      worst = max(worst, fabs(shapeCurves[c][i] - y));
+    }
+    printf("  %s table: %.2f lsb\n", shapeCurveNames[c], worst);
+    CHECK(worst <= 0.5);
+  }
+}
+
+
+
+// every input at unity drive, against the function
+void testInterpolation()
+{
+  for (uint8_t c = 0; c < NUM_SHAPE_CURVES; c++)
+  {
+    double worst = 0;
+    for (int32_t start = -32768; start < 32768; start += AUDIO_BLOCK_SAMPLES)
+    {
+      int16_t data[AUDIO_BLOCK_SAMPLES];
+      for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+        data[i] = start + i;
+
+      waveshapeBlock(data, shapeCurves[c], 256);
+
+      for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+      {
+        // the table spans -32768 to 32767 in 256 steps
+        double x = -1.0 + (start + i + 32768) / 32768.0;
+        worst = max(worst, fabs(data[i] - curves[c].f(x) * 32767));
+      }
+    }
+    printf("  %s interpolated: %.2f lsb\n", shapeCurveNames[c], worst);
+    CHECK(worst <= curves[c].maxError);
+  }
+}
+
+
+
+// drive is 8.8, clipped to the ends of the table
+void testDrive()
+{
+  int16_t data[AUDIO_BLOCK_SAMPLES] = {0};
+  data[0] = 4096;
+  data[1] = -4096;
+  data[2] = 16384;
+  data[3] = -16384;
+
+  waveshapeBlock(data, shapeCurveHard, 4 * 256);
+  CHECK(data[0] == shapeCurveHard[192]);
+  CHECK(data[1] == shapeCurveHard[64]);
+  CHECK(data[2] == shapeCurveHard[255]);
+  CHECK(data[3] == shapeCurveHard[0]);
+  CHECK(data[4] == 0);
+
+  // the node, & pass thru with no curve
+  AudioEffectWaveshapeLUT shaper;
+  audio_block_t in;
+  for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+    in.data[i] = i * 100;
+
+  hostInput = &in;
+  shaper.update();
+  CHECK(hostOutput == &in && in.data[5] == 500);
+
+  shaper.shape(shapeCurveSoft);
+  shaper.drive(2.0);
+  shaper.update();
+  CHECK(in.data[0] == 0 && in.data[5] > 1000);
+}
+
+
+
+// host time per block for each curve. Only a sanity check
+// against real time, the Teensy figures come from the 'b'
+// serial command (benchmark.h)
+void benchmark()
+{
+  int16_t data[AUDIO_BLOCK_SAMPLES];
+  int32_t sum = 0;
+
+  for (uint8_t c = 0; c < NUM_SHAPE_CURVES; c++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < BENCH_BLOCKS; n++)
+    {
+      // full scale ramp so every part of the table is read
+      for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+        data[i] = (int16_t)(i * 512 - 32768 + n);
+
+      waveshapeBlock(data, shapeCurves[c], 4 * 256);
+      sum += data[n % AUDIO_BLOCK_SAMPLES];
+    }
+    std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+
+    double samples = (double)BENCH_BLOCKS * AUDIO_BLOCK_SAMPLES;
+    double perSec = samples / secs.count();
+    printf("  %s: %.1f ns/sample, %.0fx real time\n", shapeCurveNames[c],
+           1e9 / perSec, perSec / AUDIO_SAMPLE_RATE_EXACT);
+    CHECK(perSec > AUDIO_SAMPLE_RATE_EXACT);
+  }
+
+  // keeps the loop from being optimized away
+  if (sum == 1)
+    printf(" ");
+}
+
+
+
+int main()
+{
+  testTables();
+  testInterpolation();
+  testDrive();
+  benchmark();
+
+  printf("waveshaper_test: %s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+"""
+gep_client.py - host side of the GEP binary serial protocol
+
+version 1.0   Oct 2026
+
+Talks to the framed protocol in software/protocol.h over the
+Teensy's USB serial port (needs pyserial).
+
+    gep_client.py /dev/ttyACM0 ping
+    gep_client.py /dev/ttyACM0 list
+    gep_client.py /dev/ttyACM0 get reverb.roomsize delay.time[1]
+    gep_client.py /dev/ttyACM0 set reverb.roomsize=0.6 reverb.damping=0.3
+    gep_client.py /dev/ttyACM0 stream 100
+    gep_client.py /dev/ttyACM0 save
+
+All the settings in one 'set' go in one frame, so the effect
+is updated once. Use 'sim' as the port to try it against a
+simulated device with no hardware.
+
+Debug text from the Teensy shares the port, anything that
+isn't a frame with a good CRC is skipped.
+"""
+
+import struct
+import sys
+import time
+
+SYNC = 0xA5
+MAX_PAYLOAD = 252
+
+PING, LIST, GET, SET, STREAM, SAVE = 0x01, 0x02, 0x03, 0x04, 0x05, 0x06
+REPLY = 0x80
+METERS = STREAM | REPLY
+NAK = 0xFF
+
+# EEPROM_VERSION in config.h, what the simulated device reports
+EEPROM_VERSION = 193
+
+ERRORS = {1: "bad crc", 2: "unknown command", 3: "bad length", 4: "bad param id"}
+TYPES = {0: "float", 1: "uint8", 2: "int16", 3: "bool"}
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC16-CCITT, poly 0x1021, as in protocol.h"""
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def frame(cmd, payload=b""):
+    if len(payload) > MAX_PAYLOAD:
+        raise ValueError("payload too long")
+    body = bytes([len(payload), cmd]) + payload
+    return bytes([SYNC]) + body + struct.pack("<H", crc16(body))
+
+
+class FrameReader:
+    """pulls frames out of a byte stream, skipping anything else"""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.bad = []       # commands of frames with a bad CRC
+
+    def feed(self, data):
+        self.buf += data
+        frames = []
+        while True:
+            start = self.buf.find(bytes([SYNC]))
+            if start < 0:
+                self.buf.clear()
+                return frames
+            del self.buf[:start]
+            if len(self.buf) < 5:
+                return frames
+            n = self.buf[1]
+            if n > MAX_PAYLOAD:
+                del self.buf[0]
+                continue
+            if len(self.buf) < n + 5:
+                return frames
+            body = bytes(self.buf[1:n + 3])
+            (crc,) = struct.unpack("<H", self.buf[n + 3:n + 5])
+            if crc != crc16(body):
+                self.bad.append(body[1])
+                del self.buf[0]
+                continue
+            frames.append((body[1], body[2:]))
+            del self.buf[:n + 5]
+
+
+class ProtocolError(Exception):
+    pass
+
+
+class GepClient:
+    def __init__(self, port, timeout=1.0):
+        if port == "sim":
+            self.port = SimDevice()
+        else:
+            import serial
+            self.port = serial.Serial(port, 115200, timeout=0.05)
+        self.timeout = timeout
+        self.reader = FrameReader()
+        self.pending = []
+        self.params = None
+
+    def send(self, cmd, payload=b""):
+        self.port.write(frame(cmd, payload))
+
+    def frames(self, timeout=None):
+        """yields frames as they arrive until the timeout"""
+        end = time.monotonic() + (self.timeout if timeout is None else timeout)
+        while time.monotonic() < end:
+            if not self.pending:
+                self.pending = self.reader.feed(self.port.read(256))
+                self.reader.bad.clear()
+            while self.pending:
+                yield self.pending.pop(0)
+
+    def request(self, cmd, payload=b"", reply=None):
+        self.send(cmd, payload)
+        reply = cmd | REPLY if reply is None else reply
+        for c, data in self.frames():
+            if c == NAK:
+                raise ProtocolError(ERRORS.get(data[1], "error %d" % data[1]))
+            if c == reply:
+                return data
+        raise ProtocolError("no reply")
+
+    def ping(self):
+        version, count = self.request(PING)
+        return version, count
+
+    def list(self):
+        """{name: (id, type, min, max)}"""
+        _, count = self.ping()
+        self.send(LIST)
+        params = {}
+        for c, data in self.frames():
+            if c == LIST | REPLY:
+                pid, ptype, lo, hi = struct.unpack("<BBff", data[:10])
+                params[data[10:].decode()] = (pid, ptype, lo, hi)
+                if len(params) == count:
+                    break
+        if len(params) != count:
+            raise ProtocolError("only %d of %d params listed" % (len(params), count))
+        self.params = params
+        return params
+
+    def id(self, name):
+        if self.params is None:
+            self.list()
+        if name not in self.params:
+            raise ProtocolError("unknown param " + name)
+        return self.params[name][0]
+
+    def get(self, *names):
+        data = self.request(GET, bytes(self.id(n) for n in names))
+        values = dict(struct.iter_unpack("<Bf", data))
+        return {n: values[self.id(n)] for n in names}
+
+    def set(self, **values):
+        """all in one frame, e.g. set(**{"delay.time[1]": 250})"""
+        payload = b"".join(struct.pack("<Bf", self.id(n), v) for n, v in values.items())
+        return self.request(SET, payload)[0]
+
+    def stream(self, period_ms):
+        self.send(STREAM, struct.pack("<H", period_ms))
+
+    def meters(self, timeout=None):
+        for c, data in self.frames(timeout):
+            if c == METERS:
+                yield dict(zip(("cpu", "cpu_max", "blocks", "blocks_max", "in_lufs", "out_lufs"),
+                               struct.unpack("<6f", data)))
+
+    def save(self):
+        return bool(self.request(SAVE)[0])
+
+
+class SimDevice:
+    """stands in for the Teensy, a few params & the same framing"""
+
+    PARAMS = [("reverb.enabled", 3, 0, 1), ("reverb.roomsize", 0, 0, 1),
+              ("reverb.damping", 0, 0, 1), ("delay.time[0]", 0, 0, 1000),
+              ("delay.time[1]", 0, 0, 1000), ("input.level", 1, 0, 15)]
+
+    def __init__(self):
+        self.values = [0.0] * len(self.PARAMS)
+        self.reader = FrameReader()
+        self.out = bytearray()
+        self.period = 0
+        self.last = time.monotonic()
+
+    def write(self, data):
+        for cmd, payload in self.reader.feed(data):
+            self.handle(cmd, payload)
+        # like the device, a bad CRC is NAKed
+        while self.reader.bad:
+            self.reply(NAK, bytes([self.reader.bad.pop(0), 1]))
+
+    def read(self, n):
+        if self.period and time.monotonic() - self.last >= self.period / 1000:
+            self.last = time.monotonic()
+            self.reply(METERS, struct.pack("<6f", 12.5, 20.0, 8, 14, -23.0, -18.0))
+        data = bytes(self.out[:n])
+        del self.out[:n]
+        if not data:
+            time.sleep(0.005)
+        return data
+
+    def reply(self, cmd, payload=b""):
+        self.out += frame(cmd, payload)
+
+    def handle(self, cmd, payload):
+        if cmd == PING:
+            self.reply(PING | REPLY, bytes([EEPROM_VERSION, len(self.PARAMS)]))
+        elif cmd == LIST:
+            for i, (name, ptype, lo, hi) in enumerate(self.PARAMS):
+                self.reply(LIST | REPLY, struct.pack("<BBff", i, ptype, lo, hi) + name.encode())
+        elif cmd == GET:
+            if any(i >= len(self.PARAMS) for i in payload):
+                return self.reply(NAK, bytes([cmd, 4]))
+            self.reply(GET | REPLY, b"".join(struct.pack("<Bf", i, self.values[i]) for i in payload))
+        elif cmd == SET:
+            if len(payload) % 5:
+                return self.reply(NAK, bytes([cmd, 3]))
+            for i, v in struct.iter_unpack("<Bf", payload):
+                if i >= len(self.PARAMS):
+                    return self.reply(NAK, bytes([cmd, 4]))
+                _, ptype, lo, hi = self.PARAMS[i]
+                v = min(max(v, lo), hi)
+                self.values[i] = float(round(v)) if ptype else v
+            self.reply(SET | REPLY, bytes([len(payload) // 5]))
+        elif cmd == STREAM:
+            (self.period,) = struct.unpack("<H", payload)
+        elif cmd == SAVE:
+            self.reply(SAVE | REPLY, b"\x01")
+        else:
+            self.reply(NAK, bytes([cmd, 2]))
+
+
+def main(argv):
+    if len(argv) < 3:
+        print(__doc__)
+        return 1
+
+    gep = GepClient(argv[1])
+    cmd, args = argv[2], argv[3:]
+
+    if cmd == "ping":
+        print("eeprom version %d, %d params" % gep.ping())
+    elif cmd == "list":
+        for name, (pid, ptype, lo, hi) in gep.list().items():
+            print("%3d  %-20s %-6s %g to %g" % (pid, name, TYPES.get(ptype, "?"), lo, hi))
+    elif cmd == "get":
+        for name, value in gep.get(*args).items():
+            print("%s = %g" % (name, value))
+    elif cmd == "set":
+        values = {a.split("=")[0]: float(a.split("=")[1]) for a in args}
+        print("%d set" % gep.set(**values))
+    elif cmd == "stream":
+        gep.stream(int(args[0]) if args else 100)
+        try:
+            for m in gep.meters(timeout=float("inf")):
+                print("cpu %5.1f%% (%5.1f)  blocks %3d (%3d)  in %6.1f  out %6.1f LUFS" %
+                      (m["cpu"], m["cpu_max"], m["blocks"], m["blocks_max"], m["in_lufs"], m["out_lufs"]))
+        except KeyboardInterrupt:
+            gep.stream(0)
+    elif cmd == "save":
+        print("saved" if gep.save() else "save failed")
+    else:
+        print(__doc__)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""
+reamp.py - play a DI track through the GEP and record the result
+
+version 1.0   Oct 2026
+
+Needs the GEP built with USB Type 'Audio + Serial' and
+usb.reamp turned on (e.g. with gep_client.py), plus the
+numpy & sounddevice packages.
+
+    reamp.py di.wav out.wav
+    reamp.py di.wav out.wav --device Teensy --dry dry.wav
+
+The left channel of di.wav (44.1 kHz, 16 bit) is sent to the
+GEP, and what comes back is written to out.wav. With usb.dry
+on, the right channel that comes back is the dry input,
+written to --dry, so the two can be lined up against the
+original for an A/B comparison. The recording is shifted by
+--latency samples to take out the round trip delay.
+
+The device name is matched by sounddevice, 'Teensy' finds it
+on Linux, Windows & macOS.
+
+For the simulated side of an A/B, tests/graph_run runs the
+same track thru the gate, compressor, waveshaper & EQ on the
+PC, with the same setting names:
+
+    make -C tests graph_run
+    tests/graph_run di.wav sim.wav comp.enabled=1 mix=0.5
+"""
+
+import argparse
+import sys
+import wave
+
+import numpy as np
+import sounddevice as sd
+
+RATE = 44100
+
+
+def read_wav(path):
+    with wave.open(path, "rb") as w:
+        if w.getframerate() != RATE or w.getsampwidth() != 2:
+            sys.exit("%s: needs 44.1 kHz 16 bit" % path)
+        data = np.frombuffer(w.readframes(w.getnframes()), dtype=np.int16)
+        return data.reshape(-1, w.getnchannels())[:, 0]
+
+
+def write_wav(path, samples):
+    with wave.open(path, "wb") as w:
+        w.setnchannels(1)
+        w.setsampwidth(2)
+        w.setframerate(RATE)
+        w.writeframes(samples.astype(np.int16).tobytes())
+
+
+def main():
+    parser = argparse.ArgumentParser(description="reamp a DI track through the GEP")
+    parser.add_argument("input", help="DI track, 44.1 kHz 16 bit wav")
+    parser.add_argument("output", help="processed wav to write")
+    parser.add_argument("--dry", help="also write the dry channel here")
+    parser.add_argument("--device", default="Teensy", help="audio device name")
+    parser.add_argument("--latency", type=int, default=0,
+                        help="round trip delay to remove, in samples")
+    args = parser.parse_args()
+
+    di = read_wav(args.input)
+
+    # a second of silence after, so the tails of the effects are kept
+    play = np.zeros((len(di) + RATE + args.latency, 2), dtype=np.int16)
+    play[:len(di), 0] = di
+
+    rec = sd.playrec(play, samplerate=RATE, channels=2, dtype="int16", device=args.device)
+    sd.wait()
+    rec = rec[args.latency:]
+
+    write_wav(args.output, rec[:, 0])
+    if args.dry:
+        write_wav(args.dry, rec[:, 1])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())